@@ -0,0 +1,169 @@
+"""
+Benchmark suite for matrix_ops library with roofline-style reporting
+Run with: python benchmark_matrix_ops.py [--max-size N]
+
+For each kernel we report achieved GFLOP/s and GB/s next to an estimated
+machine peak so regressions show up as a growing gap to the roofline.
+"""
+
+import argparse
+import os
+import random
+import sys
+import time
+
+try:
+    import matrix_ops
+    print(" Successfully imported matrix_ops")
+except ImportError as e:
+    print(f" Failed to import matrix_ops: {e}")
+    print("Make sure to build the library first:")
+    print("python setup.py build_ext --inplace")
+    sys.exit(1)
+
+DOUBLE_BYTES = 8
+
+def random_matrix(rows, cols, seed=0):
+    rng = random.Random(seed)
+    return matrix_ops.Matrix([[rng.uniform(-1, 1) for _ in range(cols)]
+                              for _ in range(rows)])
+
+def well_conditioned_matrix(n, seed=0):
+    """Random matrix with a boosted diagonal so inverse/determinant are stable."""
+    rng = random.Random(seed)
+    rows = [[rng.uniform(-1, 1) for _ in range(n)] for _ in range(n)]
+    for i in range(n):
+        rows[i][i] += n
+    return matrix_ops.Matrix(rows)
+
+def estimate_peak_flops():
+    """Rough machine peak in FLOP/s: cores * frequency * FMA width.
+
+    Assumes 4 doubles per vector (AVX2) and 2 FLOPs per FMA lane. This is a
+    roofline reference, not a measurement — only its order of magnitude
+    matters for spotting kernels that sit far below it.
+    """
+    cores = os.cpu_count() or 1
+    freq_hz = 3.0e9
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("cpu MHz"):
+                    freq_hz = float(line.split(":")[1]) * 1e6
+                    break
+    except OSError:
+        pass
+    return cores * freq_hz * 4 * 2
+
+def estimate_peak_bandwidth():
+    """Crude copy-bandwidth estimate in bytes/s used as the memory roofline."""
+    n = 1 << 22  # 32 MiB of doubles, well past cache
+    src = bytearray(n * DOUBLE_BYTES)
+    start = time.perf_counter()
+    reps = 8
+    for _ in range(reps):
+        dst = bytes(src)
+    elapsed = time.perf_counter() - start
+    # One read + one write per copied byte
+    return 2 * reps * len(src) / elapsed
+
+def time_op(fn, min_time=0.2, max_reps=1000):
+    """Run fn repeatedly for at least min_time seconds, return seconds/call."""
+    fn()  # warm-up
+    reps = 0
+    start = time.perf_counter()
+    while True:
+        fn()
+        reps += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= min_time or reps >= max_reps:
+            return elapsed / reps
+
+def report(name, n, seconds, flops, bytes_moved, peak_flops, peak_bw):
+    gflops = flops / seconds / 1e9
+    gbytes = bytes_moved / seconds / 1e9
+    pct_flops = 100.0 * flops / seconds / peak_flops
+    pct_bw = 100.0 * bytes_moved / seconds / peak_bw
+    print(f" {name:<14} n={n:<5} {seconds * 1e3:10.3f} ms "
+          f"{gflops:9.2f} GFLOP/s ({pct_flops:5.1f}% peak) "
+          f"{gbytes:8.2f} GB/s ({pct_bw:5.1f}% peak)")
+
+def bench_multiply(sizes, peak_flops, peak_bw):
+    print("\n=== Benchmarking multiply ===")
+    for n in sizes:
+        A = random_matrix(n, n, seed=1)
+        B = random_matrix(n, n, seed=2)
+        seconds = time_op(lambda: A.multiply(B))
+        flops = 2.0 * n * n * n
+        bytes_moved = 3 * n * n * DOUBLE_BYTES
+        report("multiply", n, seconds, flops, bytes_moved, peak_flops, peak_bw)
+
+def bench_determinant(sizes, peak_flops, peak_bw):
+    print("\n=== Benchmarking determinant ===")
+    for n in sizes:
+        A = well_conditioned_matrix(n, seed=3)
+        seconds = time_op(lambda: A.determinant())
+        flops = 2.0 * n * n * n / 3.0
+        bytes_moved = n * n * DOUBLE_BYTES
+        report("determinant", n, seconds, flops, bytes_moved, peak_flops, peak_bw)
+
+def bench_inverse(sizes, peak_flops, peak_bw):
+    print("\n=== Benchmarking inverse ===")
+    for n in sizes:
+        A = well_conditioned_matrix(n, seed=4)
+        seconds = time_op(lambda: A.inverse())
+        flops = 2.0 * n * n * n
+        bytes_moved = 2 * n * n * DOUBLE_BYTES
+        report("inverse", n, seconds, flops, bytes_moved, peak_flops, peak_bw)
+
+def bench_dot_product(sizes, peak_flops, peak_bw):
+    print("\n=== Benchmarking dot_product ===")
+    for n in sizes:
+        length = n * n  # scale vector length with the matrix sizes
+        # Zero-copy row views, so we time the kernel and not a list conversion
+        a = random_matrix(1, length, seed=5).row_view(0)
+        b = random_matrix(1, length, seed=6).row_view(0)
+        seconds = time_op(lambda: matrix_ops.dot_product(a, b))
+        flops = 2.0 * length
+        bytes_moved = 2 * length * DOUBLE_BYTES
+        report("dot_product", n, seconds, flops, bytes_moved, peak_flops, peak_bw)
+
+def bench_construction(sizes, peak_flops, peak_bw):
+    print("\n=== Benchmarking construction/conversion ===")
+    for n in sizes:
+        rows = [[float(i + j) for j in range(n)] for i in range(n)]
+        seconds = time_op(lambda: matrix_ops.Matrix(rows))
+        bytes_moved = 2 * n * n * DOUBLE_BYTES
+        report("construct", n, seconds, 0.0, bytes_moved, peak_flops, peak_bw)
+
+        A = random_matrix(n, n, seed=7)
+        seconds = time_op(lambda: A.get_data())
+        report("get_data", n, seconds, 0.0, bytes_moved, peak_flops, peak_bw)
+
+def main():
+    parser = argparse.ArgumentParser(description="matrix_ops benchmarks")
+    parser.add_argument("--max-size", type=int, default=1024,
+                        help="largest matrix dimension to benchmark "
+                             "(default 1024; use 4096 for full runs)")
+    args = parser.parse_args()
+
+    sizes = [3, 16, 64, 256, 1024, 4096]
+    sizes = [n for n in sizes if n <= args.max_size]
+
+    peak_flops = estimate_peak_flops()
+    peak_bw = estimate_peak_bandwidth()
+    print(f"\nEstimated machine peak: {peak_flops / 1e9:.1f} GFLOP/s, "
+          f"{peak_bw / 1e9:.1f} GB/s")
+
+    bench_multiply(sizes, peak_flops, peak_bw)
+    # O(n^3) factorizations get slow past 1024 without adding information
+    dense_sizes = [n for n in sizes if n <= 1024]
+    bench_determinant(dense_sizes, peak_flops, peak_bw)
+    bench_inverse(dense_sizes, peak_flops, peak_bw)
+    bench_dot_product(sizes, peak_flops, peak_bw)
+    bench_construction(dense_sizes, peak_flops, peak_bw)
+
+    print("\n Benchmarks complete")
+
+if __name__ == "__main__":
+    main()
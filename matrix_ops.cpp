@@ -8,204 +8,4239 @@
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <tuple>
+
+// POSIX memory mapping for the persisted matrix format
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The hot kernels (micro-kernels, dot product) are compiled at several ISA
+// levels into this one binary via per-function target attributes and picked
+// by CPUID at import (see the dispatch block below the kernels), so a single
+// build runs near-native on every host tier. Non-x86 builds get the scalar
+// paths only.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MATRIX_OPS_X86 1
+#define MATRIX_OPS_TARGET(isa) __attribute__((target(isa)))
+#endif
 
 namespace py = pybind11;
 
-/*
-This code implements a simple matrix operations library in C++.
-The class `Matrix` supports basic operations such as:
-- Matrix multiplication
-- Determinant calculation
-- Matrix inversion using Gauss-Jordan elimination
-It also provides vector operations like dot product and cross product.
-The library is designed to be used with Python through pybind11,
-allowing users to create matrices, perform operations, and retrieve results in a Python-friendly format.
-The `Matrix` class can be initialized with a specific size or with a 2D vector,
-and it provides methods to access elements, get dimensions, and perform operations.
-The library is intended for educational purposes and basic numerical computations,
-and it includes error handling for invalid operations such as dimension mismatches and singular matrices.
-*/
+/*
+This code implements a simple matrix operations library in C++.
+The class `Matrix` supports basic operations such as:
+- Matrix multiplication
+- Determinant calculation
+- Matrix inversion using Gauss-Jordan elimination
+It also provides vector operations like dot product and cross product.
+The library is designed to be used with Python through pybind11,
+allowing users to create matrices, perform operations, and retrieve results in a Python-friendly format.
+The `Matrix` class can be initialized with a specific size or with a 2D vector,
+and it provides methods to access elements, get dimensions, and perform operations.
+The library is intended for educational purposes and basic numerical computations,
+and it includes error handling for invalid operations such as dimension mismatches and singular matrices.
+*/
+
+// --- Thread pool ---
+// A single process-wide pool of worker threads, started lazily on first use
+// and reused for every parallel kernel. Spawning threads per call would cost
+// more than the math for mid-sized matrices, so workers block on a task queue
+// instead. The calling thread always takes a share of the range itself.
+//
+// Sizing: MATRIX_OPS_NUM_THREADS (or, failing that, OMP_NUM_THREADS) caps
+// the pool at startup so co-located processes can partition a box without
+// code changes; set_num_threads() adjusts it at runtime. When the process
+// runs under a restricted CPU mask (taskset/cpuset -- the normal deployment
+// for one worker process per NUMA node), each pool thread is pinned to one
+// allowed core, so its scratch arena and the buffer chunks it first touches
+// stay on that core's memory node. MATRIX_OPS_PIN_THREADS=1 forces pinning
+// on an unrestricted mask.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Workers plus the calling thread
+    size_t threadCount() const { return totalThreads.load(); }
+
+    // Re-size the pool to `total` threads including the calling thread.
+    // Serialized against in-flight parallelFor calls: their chunk tasks are
+    // only ever run by the workers that existed when they were enqueued, so
+    // resize waits for running loops to finish (and blocks new ones) before
+    // it tears the workers down. Compute entry points release the GIL, so a
+    // second Python thread really can get here mid-multiply.
+    void resize(size_t total) {
+        if (total == 0) {
+            total = 1;
+        }
+        std::unique_lock<std::mutex> rlock(resizeMutex);
+        resizeCond.wait(rlock, [this]() { return activeLoops == 0 && !resizing; });
+        resizing = true;
+        rlock.unlock();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCond.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+        workers.clear();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = false;
+        }
+        spawn(total - 1);
+        totalThreads.store(total);
+
+        rlock.lock();
+        resizing = false;
+        resizeCond.notify_all();
+    }
+
+    // Split [begin, end) into one contiguous chunk per thread and run
+    // body(chunkBegin, chunkEnd) on each; blocks until every chunk is done.
+    void parallelFor(size_t begin, size_t end,
+                     const std::function<void(size_t, size_t)>& body) {
+        const size_t n = end > begin ? end - begin : 0;
+        if (n == 0) return;
+        beginLoop();
+        const size_t parts = std::min(threadCount(), n);
+        if (parts <= 1) {
+            body(begin, end);
+            endLoop();
+            return;
+        }
+        const size_t chunk = (n + parts - 1) / parts;
+        // The handshake state lives on this frame, so the waiter below must
+        // not be able to return while a worker still touches it: the
+        // decrement happens under doneMutex, which means the waiter cannot
+        // observe zero before the last worker has released the lock.
+        size_t pending = parts - 1;
+        std::mutex doneMutex;
+        std::condition_variable doneCond;
+        for (size_t p = 1; p < parts; ++p) {
+            const size_t b = begin + p * chunk;
+            const size_t e = std::min(end, b + chunk);
+            enqueue([&, b, e]() {
+                if (b < e) body(b, e);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--pending == 0) {
+                    doneCond.notify_one();
+                }
+            });
+        }
+        body(begin, std::min(end, begin + chunk));
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCond.wait(lock, [&]() { return pending == 0; });
+        }
+        endLoop();
+    }
+
+private:
+    ThreadPool() : stopping(false), resizing(false), activeLoops(0), totalThreads(1) {
+        const size_t total = configuredThreads();
+        spawn(total - 1);
+        totalThreads.store(total);
+    }
+
+    // Default pool size: env override first, hardware_concurrency otherwise
+    static size_t configuredThreads() {
+        const char* env = std::getenv("MATRIX_OPS_NUM_THREADS");
+        if (!env) {
+            env = std::getenv("OMP_NUM_THREADS");
+        }
+        if (env) {
+            const long v = std::atol(env);
+            if (v > 0) {
+                return static_cast<size_t>(v);
+            }
+        }
+        const size_t hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    void spawn(size_t count) {
+        workers.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            // Worker i takes allowed-CPU slot i+1; slot 0 is left for the
+            // calling thread.
+            workers.emplace_back([this, i]() {
+                pinWorker(i + 1);
+                workerLoop();
+            });
+        }
+    }
+
+    // Best-effort pinning of a pool thread to the index-th CPU of the
+    // process affinity mask. Only done when the mask is already restricted
+    // (or pinning is forced via env): on an unrestricted mask several
+    // co-located processes would all pile onto the same low-numbered cores.
+    // Failures just leave the thread where the scheduler put it.
+    static void pinWorker(size_t index) {
+#ifdef __linux__
+        cpu_set_t mask;
+        if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+            return;
+        }
+        const int allowed = CPU_COUNT(&mask);
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        const char* force = std::getenv("MATRIX_OPS_PIN_THREADS");
+        const bool pin = (force && std::atol(force) > 0) ||
+                         (online > 0 && allowed < online);
+        if (!pin || allowed <= 0) {
+            return;
+        }
+        const int want = static_cast<int>(index % static_cast<size_t>(allowed));
+        int seen = 0;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &mask)) {
+                continue;
+            }
+            if (seen++ == want) {
+                cpu_set_t one;
+                CPU_ZERO(&one);
+                CPU_SET(cpu, &one);
+                sched_setaffinity(0, sizeof(one), &one);
+                return;
+            }
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCond.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    // Reader side of the resize gate: a loop holds the worker set stable for
+    // its whole duration; a pending resize makes new loops wait for the new
+    // pool instead of enqueueing against workers about to exit.
+    void beginLoop() {
+        std::unique_lock<std::mutex> rlock(resizeMutex);
+        resizeCond.wait(rlock, [this]() { return !resizing; });
+        ++activeLoops;
+    }
+
+    void endLoop() {
+        std::lock_guard<std::mutex> rlock(resizeMutex);
+        if (--activeLoops == 0) {
+            resizeCond.notify_all();
+        }
+    }
+
+    void enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            tasks.push(std::move(task));
+        }
+        queueCond.notify_one();
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCond.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::mutex resizeMutex;
+    std::condition_variable queueCond;
+    std::condition_variable resizeCond;
+    bool stopping;
+    bool resizing;
+    size_t activeLoops;  // parallelFor calls currently in flight
+    std::atomic<size_t> totalThreads;
+};
+
+// Below this many multiply-add operations a kernel stays single-threaded;
+// the pool handoff costs more than the arithmetic saves.
+static const size_t PARALLEL_MIN_FLOPS = 1 << 18;
+
+// --- Scratch arena ---
+// Per-thread bump allocator for kernel temporaries (pack buffers, augmented
+// matrices, LU working copies). Repeated same-size operations were hitting
+// malloc once per call -- contended under multi-threaded Python workers and
+// a steady source of heap fragmentation over days of uptime. The arena hands
+// out slices of one warm, already-faulted block and resets when the outermost
+// frame returns; the block only regrows between frames, to the high-water
+// demand of the previous one, so steady-state operation does no allocation
+// at all. Pool workers get their own arena via thread_local.
+class ScratchArena {
+public:
+    static ScratchArena& local() {
+        static thread_local ScratchArena arena;
+        return arena;
+    }
+
+    // Bump-allocate n elements of T, 64-byte aligned. Allocations that
+    // outgrow the block spill to a one-off malloc that is freed (and the
+    // block regrown) when the frame stack empties.
+    template <typename T>
+    T* alloc(size_t n) {
+        const size_t bytes = (n * sizeof(T) + 63) & ~size_t(63);
+        demand = std::max(demand, used + bytes);
+        if (used + bytes > block.size()) {
+            overflow.emplace_back(new char[bytes + 64]);
+            char* p = overflow.back().get();
+            size_t misalign = reinterpret_cast<uintptr_t>(p) & 63;
+            return reinterpret_cast<T*>(p + (misalign ? 64 - misalign : 0));
+        }
+        char* p = block.data() + used;
+        used += bytes;
+        return reinterpret_cast<T*>(p);
+    }
+
+    size_t mark() const { return used; }
+
+    void release(size_t m) {
+        used = m;
+        if (used == 0) {
+            overflow.clear();
+            if (block.size() < demand) {
+                block.assign(demand, 0);  // regrow once, stay warm afterwards
+            }
+        }
+    }
+
+private:
+    ScratchArena() : used(0), demand(0) {}
+    std::vector<char> block;
+    std::vector<std::unique_ptr<char[]>> overflow;
+    size_t used;
+    size_t demand;
+};
+
+// RAII frame over the thread's arena: everything allocated through the frame
+// is handed back when it goes out of scope. Frames nest; memory is recycled
+// when the outermost one unwinds.
+class ScratchFrame {
+public:
+    ScratchFrame() : arena(ScratchArena::local()), base(arena.mark()) {}
+    ~ScratchFrame() { arena.release(base); }
+
+    template <typename T>
+    T* alloc(size_t n) { return arena.alloc<T>(n); }
+
+    ScratchFrame(const ScratchFrame&) = delete;
+    ScratchFrame& operator=(const ScratchFrame&) = delete;
+
+private:
+    ScratchArena& arena;
+    size_t base;
+};
+
+// --- Performance counters ---
+// Always-on per-operation counters: each thread owns a slot array only it
+// writes, and perf_stats() folds the live slots plus the totals of exited
+// threads under a mutex only when asked. The live fields are relaxed
+// atomics so snapshot() reading another thread's slot is defined behavior
+// rather than a torn read; with a single writer per slot the relaxed
+// load-add-store compiles to the same plain MOVs as a non-atomic bump, so
+// the hot path still takes no locks and no fences. That keeps it
+// unperturbed while making "which call got slow" answerable from inside
+// the process instead of with wall-clock timers around the Python call
+// sites.
+class PerfCounters {
+public:
+    enum Op { OpMultiply = 0, OpInverse, OpDeterminant, OpCount };
+
+    // Plain aggregate used for snapshots and the retired totals (both only
+    // touched under the registry mutex).
+    struct Slot {
+        uint64_t calls, ns, flops, bytes, allocs;
+    };
+
+    // Live per-thread counters; see the class comment for the memory model.
+    struct LiveSlot {
+        std::atomic<uint64_t> calls{0}, ns{0}, flops{0}, bytes{0}, allocs{0};
+    };
+
+    static const char* opName(int op) {
+        static const char* const names[OpCount] = {"multiply", "inverse", "determinant"};
+        return names[op];
+    }
+
+    static PerfCounters& local();
+
+    void record(Op op, uint64_t ns, uint64_t flops, uint64_t bytes) {
+        LiveSlot& s = slots[op];
+        bump(s.calls, 1);
+        bump(s.ns, ns);
+        bump(s.flops, flops);
+        bump(s.bytes, bytes);
+    }
+
+    void addAlloc(Op op) { bump(slots[op].allocs, 1); }
+
+    static std::array<Slot, OpCount> snapshot() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::array<Slot, OpCount> out = retired();
+        for (const PerfCounters* c : registry()) {
+            for (int op = 0; op < OpCount; ++op) {
+                const LiveSlot& s = c->slots[op];
+                out[op].calls += s.calls.load(std::memory_order_relaxed);
+                out[op].ns += s.ns.load(std::memory_order_relaxed);
+                out[op].flops += s.flops.load(std::memory_order_relaxed);
+                out[op].bytes += s.bytes.load(std::memory_order_relaxed);
+                out[op].allocs += s.allocs.load(std::memory_order_relaxed);
+            }
+        }
+        return out;
+    }
+
+    static void reset() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        retired() = std::array<Slot, OpCount>();
+        for (PerfCounters* c : registry()) {
+            for (LiveSlot& s : c->slots) {
+                s.calls.store(0, std::memory_order_relaxed);
+                s.ns.store(0, std::memory_order_relaxed);
+                s.flops.store(0, std::memory_order_relaxed);
+                s.bytes.store(0, std::memory_order_relaxed);
+                s.allocs.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Holder;
+    friend struct Holder;
+
+    static std::mutex& registryMutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    static std::vector<PerfCounters*>& registry() {
+        static std::vector<PerfCounters*> r;
+        return r;
+    }
+
+    static std::array<Slot, OpCount>& retired() {
+        static std::array<Slot, OpCount> r;
+        return r;
+    }
+
+    // Single-writer bump: a relaxed load-add-store stays plain MOVs where a
+    // fetch_add would turn into a locked RMW the owning thread doesn't need.
+    static void bump(std::atomic<uint64_t>& c, uint64_t v) {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    std::array<LiveSlot, OpCount> slots;
+};
+
+// Registers the thread's slots on first use and folds them into the retired
+// totals when the thread exits, so history survives the thread.
+struct PerfCounters::Holder {
+    PerfCounters counters;
+    Holder() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().push_back(&counters);
+    }
+    ~Holder() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (int op = 0; op < OpCount; ++op) {
+            const LiveSlot& s = counters.slots[op];
+            retired()[op].calls += s.calls.load(std::memory_order_relaxed);
+            retired()[op].ns += s.ns.load(std::memory_order_relaxed);
+            retired()[op].flops += s.flops.load(std::memory_order_relaxed);
+            retired()[op].bytes += s.bytes.load(std::memory_order_relaxed);
+            retired()[op].allocs += s.allocs.load(std::memory_order_relaxed);
+        }
+        auto& reg = registry();
+        reg.erase(std::find(reg.begin(), reg.end(), &counters));
+    }
+};
+
+inline PerfCounters& PerfCounters::local() {
+    static thread_local Holder holder;
+    return holder.counters;
+}
+
+// Chrome-tracing span output, switched by the MATRIX_OPS_TRACE env var: set
+// it to a path and every multiply/inverse/determinant emits one complete
+// ("X") event there. The file opens on first span and stays an unterminated
+// JSON array, which the chrome://tracing / Perfetto loaders accept.
+class PerfTracer {
+public:
+    static void emit(const char* name, uint64_t tsUs, uint64_t durUs) {
+        static std::mutex mu;
+        std::lock_guard<std::mutex> lock(mu);
+        static FILE* f = openFile();
+        if (!f) return;
+        std::fprintf(f,
+                     "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%llu,"
+                     "\"ts\":%llu,\"dur\":%llu},\n",
+                     name,
+                     static_cast<unsigned long long>(
+                         std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffff),
+                     static_cast<unsigned long long>(tsUs),
+                     static_cast<unsigned long long>(durUs));
+        std::fflush(f);
+    }
+
+    static bool enabled() {
+        static const bool on = std::getenv("MATRIX_OPS_TRACE") != nullptr;
+        return on;
+    }
+
+private:
+    static FILE* openFile() {
+        const char* path = std::getenv("MATRIX_OPS_TRACE");
+        if (!path) return nullptr;
+        FILE* f = std::fopen(path, "w");
+        if (f) std::fprintf(f, "[\n");
+        return f;
+    }
+};
+
+// RAII scope: times the enclosed operation, records it into the thread's
+// counter slot and, when tracing is on, emits the span.
+class PerfScope {
+public:
+    PerfScope(PerfCounters::Op op, uint64_t flops, uint64_t bytes)
+        : op(op), flops(flops), bytes(bytes),
+          start(std::chrono::steady_clock::now()) {}
+
+    ~PerfScope() {
+        const auto end = std::chrono::steady_clock::now();
+        const uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        PerfCounters::local().record(op, ns, flops, bytes);
+        if (PerfTracer::enabled()) {
+            const uint64_t tsUs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    start.time_since_epoch()).count());
+            PerfTracer::emit(PerfCounters::opName(op), tsUs, ns / 1000);
+        }
+    }
+
+private:
+    PerfCounters::Op op;
+    uint64_t flops, bytes;
+    std::chrono::steady_clock::time_point start;
+};
+
+// --- Runtime ISA dispatch ---
+// One shipped binary, several kernel tiers: each hot kernel below exists in
+// a scalar version plus AVX2/FMA and AVX-512 versions compiled with
+// per-function target attributes, and a CPUID probe at import wires the best
+// supported one into a function pointer. Call sites see one name and pay one
+// indirect call per kernel invocation -- noise next to the tile of work each
+// call does.
+enum SimdTier { SimdScalar = 0, SimdAvx2 = 1, SimdAvx512 = 2 };
+
+static SimdTier detectSimdTier() {
+    SimdTier hw = SimdScalar;
+#ifdef MATRIX_OPS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        hw = SimdAvx512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        hw = SimdAvx2;
+    }
+#endif
+    // MATRIX_OPS_ISA caps the tier (scalar / avx2 / avx512) -- a rollback
+    // lever for bad microcode days, never a way to run unsupported
+    // instructions.
+    const char* cap = std::getenv("MATRIX_OPS_ISA");
+    if (cap) {
+        if (std::strcmp(cap, "scalar") == 0) {
+            hw = SimdScalar;
+        } else if (std::strcmp(cap, "avx2") == 0 && hw > SimdAvx2) {
+            hw = SimdAvx2;
+        }
+    }
+    return hw;
+}
+
+static const SimdTier SIMD_TIER = detectSimdTier();
+
+// --- Blocked matrix-multiplication kernel ---
+// The naive i-j-k loop strides down columns of B and misses cache on nearly
+// every access once the matrices outgrow L2. The kernel below tiles the
+// iteration space so each B panel is packed into a contiguous scratch buffer
+// and reused from L1/L2 across a whole block of A rows, and the micro-kernel
+// keeps a small register block of C live across the k loop.
+//
+// Tile sizes: a KC x NC panel of B (~1MB) targets L2, a row block of MC A rows
+// keeps the A operand resident in L1 while the panel is consumed.
+static const size_t GEMM_MC = 64;   // rows of A per block
+static const size_t GEMM_KC = 256;  // depth of the packed B panel
+static const size_t GEMM_NC = 512;  // width of the packed B panel
+static const size_t GEMM_MR = 4;    // register-blocked rows in the micro-kernel
+
+// Copy the kc x nc panel B[0..kc, 0..nc] (leading dimension ldb) into a
+// contiguous buffer so the micro-kernel streams it linearly.
+static void gemmPackB(const double* B, size_t ldb, size_t kc, size_t nc, double* Bp) {
+    for (size_t k = 0; k < kc; ++k) {
+        const double* src = B + k * ldb;
+        double* dst = Bp + k * nc;
+        for (size_t j = 0; j < nc; ++j) {
+            dst[j] = src[j];
+        }
+    }
+}
+
+// Micro-kernel: C[0..mr, 0..nc] += A[0..mr, 0..kc] * Bp, where Bp is the
+// packed kc x nc panel. Processing GEMM_MR rows of A at once reuses every
+// packed B line GEMM_MR times while it is hot in L1. Three ISA versions of
+// the same blocking scheme; the dispatch pointer below picks one at import.
+static void gemmMicroKernelScalar(const double* A, size_t lda,
+                                  const double* Bp, double* C, size_t ldc,
+                                  size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        double* c0 = C + (i + 0) * ldc;
+        double* c1 = C + (i + 1) * ldc;
+        double* c2 = C + (i + 2) * ldc;
+        double* c3 = C + (i + 3) * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const double a0 = A[(i + 0) * lda + k];
+            const double a1 = A[(i + 1) * lda + k];
+            const double a2 = A[(i + 2) * lda + k];
+            const double a3 = A[(i + 3) * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                const double bj = b[j];
+                c0[j] += a0 * bj;
+                c1[j] += a1 * bj;
+                c2[j] += a2 * bj;
+                c3[j] += a3 * bj;
+            }
+        }
+    }
+    for (; i < mr; ++i) {
+        double* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const double a = A[i * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+#ifdef MATRIX_OPS_X86
+MATRIX_OPS_TARGET("avx2,fma")
+static void gemmMicroKernelAvx2(const double* A, size_t lda,
+                                const double* Bp, double* C, size_t ldc,
+                                size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        double* c0 = C + (i + 0) * ldc;
+        double* c1 = C + (i + 1) * ldc;
+        double* c2 = C + (i + 2) * ldc;
+        double* c3 = C + (i + 3) * ldc;
+        // 4x8 register block: eight FMA accumulators stay live across the
+        // whole k loop, so C traffic happens once per tile instead of once
+        // per k iteration.
+        size_t j = 0;
+        for (; j + 8 <= nc; j += 8) {
+            __m256d acc00 = _mm256_setzero_pd(), acc01 = _mm256_setzero_pd();
+            __m256d acc10 = _mm256_setzero_pd(), acc11 = _mm256_setzero_pd();
+            __m256d acc20 = _mm256_setzero_pd(), acc21 = _mm256_setzero_pd();
+            __m256d acc30 = _mm256_setzero_pd(), acc31 = _mm256_setzero_pd();
+            for (size_t k = 0; k < kc; ++k) {
+                const double* b = Bp + k * nc + j;
+                const __m256d b0 = _mm256_loadu_pd(b);
+                const __m256d b1 = _mm256_loadu_pd(b + 4);
+                const __m256d a0 = _mm256_broadcast_sd(A + (i + 0) * lda + k);
+                acc00 = _mm256_fmadd_pd(a0, b0, acc00);
+                acc01 = _mm256_fmadd_pd(a0, b1, acc01);
+                const __m256d a1 = _mm256_broadcast_sd(A + (i + 1) * lda + k);
+                acc10 = _mm256_fmadd_pd(a1, b0, acc10);
+                acc11 = _mm256_fmadd_pd(a1, b1, acc11);
+                const __m256d a2 = _mm256_broadcast_sd(A + (i + 2) * lda + k);
+                acc20 = _mm256_fmadd_pd(a2, b0, acc20);
+                acc21 = _mm256_fmadd_pd(a2, b1, acc21);
+                const __m256d a3 = _mm256_broadcast_sd(A + (i + 3) * lda + k);
+                acc30 = _mm256_fmadd_pd(a3, b0, acc30);
+                acc31 = _mm256_fmadd_pd(a3, b1, acc31);
+            }
+            _mm256_storeu_pd(c0 + j, _mm256_add_pd(_mm256_loadu_pd(c0 + j), acc00));
+            _mm256_storeu_pd(c0 + j + 4, _mm256_add_pd(_mm256_loadu_pd(c0 + j + 4), acc01));
+            _mm256_storeu_pd(c1 + j, _mm256_add_pd(_mm256_loadu_pd(c1 + j), acc10));
+            _mm256_storeu_pd(c1 + j + 4, _mm256_add_pd(_mm256_loadu_pd(c1 + j + 4), acc11));
+            _mm256_storeu_pd(c2 + j, _mm256_add_pd(_mm256_loadu_pd(c2 + j), acc20));
+            _mm256_storeu_pd(c2 + j + 4, _mm256_add_pd(_mm256_loadu_pd(c2 + j + 4), acc21));
+            _mm256_storeu_pd(c3 + j, _mm256_add_pd(_mm256_loadu_pd(c3 + j), acc30));
+            _mm256_storeu_pd(c3 + j + 4, _mm256_add_pd(_mm256_loadu_pd(c3 + j + 4), acc31));
+        }
+        // Remainder columns, scalar
+        for (size_t k = 0; k < kc; ++k) {
+            const double a0 = A[(i + 0) * lda + k];
+            const double a1 = A[(i + 1) * lda + k];
+            const double a2 = A[(i + 2) * lda + k];
+            const double a3 = A[(i + 3) * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t jj = j; jj < nc; ++jj) {
+                const double bj = b[jj];
+                c0[jj] += a0 * bj;
+                c1[jj] += a1 * bj;
+                c2[jj] += a2 * bj;
+                c3[jj] += a3 * bj;
+            }
+        }
+    }
+    // Remainder rows, one at a time
+    for (; i < mr; ++i) {
+        double* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const double a = A[i * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+MATRIX_OPS_TARGET("avx512f")
+static void gemmMicroKernelAvx512(const double* A, size_t lda,
+                                  const double* Bp, double* C, size_t ldc,
+                                  size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        double* c0 = C + (i + 0) * ldc;
+        double* c1 = C + (i + 1) * ldc;
+        double* c2 = C + (i + 2) * ldc;
+        double* c3 = C + (i + 3) * ldc;
+        // 4x16 register block: the AVX2 tile with zmm lanes, so each packed
+        // B line feeds twice the columns per instruction
+        size_t j = 0;
+        for (; j + 16 <= nc; j += 16) {
+            __m512d acc00 = _mm512_setzero_pd(), acc01 = _mm512_setzero_pd();
+            __m512d acc10 = _mm512_setzero_pd(), acc11 = _mm512_setzero_pd();
+            __m512d acc20 = _mm512_setzero_pd(), acc21 = _mm512_setzero_pd();
+            __m512d acc30 = _mm512_setzero_pd(), acc31 = _mm512_setzero_pd();
+            for (size_t k = 0; k < kc; ++k) {
+                const double* b = Bp + k * nc + j;
+                const __m512d b0 = _mm512_loadu_pd(b);
+                const __m512d b1 = _mm512_loadu_pd(b + 8);
+                const __m512d a0 = _mm512_set1_pd(A[(i + 0) * lda + k]);
+                acc00 = _mm512_fmadd_pd(a0, b0, acc00);
+                acc01 = _mm512_fmadd_pd(a0, b1, acc01);
+                const __m512d a1 = _mm512_set1_pd(A[(i + 1) * lda + k]);
+                acc10 = _mm512_fmadd_pd(a1, b0, acc10);
+                acc11 = _mm512_fmadd_pd(a1, b1, acc11);
+                const __m512d a2 = _mm512_set1_pd(A[(i + 2) * lda + k]);
+                acc20 = _mm512_fmadd_pd(a2, b0, acc20);
+                acc21 = _mm512_fmadd_pd(a2, b1, acc21);
+                const __m512d a3 = _mm512_set1_pd(A[(i + 3) * lda + k]);
+                acc30 = _mm512_fmadd_pd(a3, b0, acc30);
+                acc31 = _mm512_fmadd_pd(a3, b1, acc31);
+            }
+            _mm512_storeu_pd(c0 + j, _mm512_add_pd(_mm512_loadu_pd(c0 + j), acc00));
+            _mm512_storeu_pd(c0 + j + 8, _mm512_add_pd(_mm512_loadu_pd(c0 + j + 8), acc01));
+            _mm512_storeu_pd(c1 + j, _mm512_add_pd(_mm512_loadu_pd(c1 + j), acc10));
+            _mm512_storeu_pd(c1 + j + 8, _mm512_add_pd(_mm512_loadu_pd(c1 + j + 8), acc11));
+            _mm512_storeu_pd(c2 + j, _mm512_add_pd(_mm512_loadu_pd(c2 + j), acc20));
+            _mm512_storeu_pd(c2 + j + 8, _mm512_add_pd(_mm512_loadu_pd(c2 + j + 8), acc21));
+            _mm512_storeu_pd(c3 + j, _mm512_add_pd(_mm512_loadu_pd(c3 + j), acc30));
+            _mm512_storeu_pd(c3 + j + 8, _mm512_add_pd(_mm512_loadu_pd(c3 + j + 8), acc31));
+        }
+        // Remainder columns, scalar
+        for (size_t k = 0; k < kc; ++k) {
+            const double a0 = A[(i + 0) * lda + k];
+            const double a1 = A[(i + 1) * lda + k];
+            const double a2 = A[(i + 2) * lda + k];
+            const double a3 = A[(i + 3) * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t jj = j; jj < nc; ++jj) {
+                const double bj = b[jj];
+                c0[jj] += a0 * bj;
+                c1[jj] += a1 * bj;
+                c2[jj] += a2 * bj;
+                c3[jj] += a3 * bj;
+            }
+        }
+    }
+    // Remainder rows, one at a time
+    for (; i < mr; ++i) {
+        double* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const double a = A[i * lda + k];
+            const double* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+#endif  // MATRIX_OPS_X86
+
+static void (*pickGemmMicroKernel())(const double*, size_t, const double*,
+                                     double*, size_t, size_t, size_t, size_t) {
+#ifdef MATRIX_OPS_X86
+    if (SIMD_TIER == SimdAvx512) return gemmMicroKernelAvx512;
+    if (SIMD_TIER == SimdAvx2) return gemmMicroKernelAvx2;
+#endif
+    return gemmMicroKernelScalar;
+}
+
+static void (*const gemmMicroKernel)(const double*, size_t, const double*,
+                                     double*, size_t, size_t, size_t, size_t) =
+    pickGemmMicroKernel();
+
+// C += A * B for row-major operands with explicit leading dimensions.
+// C must be zeroed (or hold the value to accumulate into) by the caller.
+static void gemmBlocked(const double* A, size_t lda,
+                        const double* B, size_t ldb,
+                        double* C, size_t ldc,
+                        size_t M, size_t N, size_t K) {
+    ScratchFrame scratch;
+    double* Bpack = scratch.alloc<double>(GEMM_KC * GEMM_NC);
+    for (size_t jc = 0; jc < N; jc += GEMM_NC) {
+        const size_t nc = std::min(GEMM_NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += GEMM_KC) {
+            const size_t kc = std::min(GEMM_KC, K - pc);
+            gemmPackB(B + pc * ldb + jc, ldb, kc, nc, Bpack);
+            for (size_t ic = 0; ic < M; ic += GEMM_MC) {
+                const size_t mc = std::min(GEMM_MC, M - ic);
+                gemmMicroKernel(A + ic * lda + pc, lda, Bpack,
+                                C + ic * ldc + jc, ldc, mc, kc, nc);
+            }
+        }
+    }
+}
+
+// Like gemmPackB, but folds a scalar into the panel while it is being
+// moved anyway — how the fused entry point below applies alpha for free.
+static void gemmPackBScaled(const double* B, size_t ldb, size_t kc, size_t nc,
+                            double alpha, double* Bp) {
+    for (size_t k = 0; k < kc; ++k) {
+        const double* src = B + k * ldb;
+        double* dst = Bp + k * nc;
+        for (size_t j = 0; j < nc; ++j) {
+            dst[j] = alpha * src[j];
+        }
+    }
+}
+
+// Fused C = alpha*A*B + beta*C over the same blocking. alpha rides along in
+// the B pack, and each C tile is scaled by beta just before its first
+// K-panel touches it — while the tile is headed into cache anyway — so the
+// update costs no separate read-modify-write sweep of C. beta == 0 stores
+// instead of scaling, so uninitialized (or NaN) C contents never propagate.
+static void gemmBlockedScaled(const double* A, size_t lda,
+                              const double* B, size_t ldb,
+                              double* C, size_t ldc,
+                              size_t M, size_t N, size_t K,
+                              double alpha, double beta) {
+    ScratchFrame scratch;
+    double* Bpack = scratch.alloc<double>(GEMM_KC * GEMM_NC);
+    for (size_t jc = 0; jc < N; jc += GEMM_NC) {
+        const size_t nc = std::min(GEMM_NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += GEMM_KC) {
+            const size_t kc = std::min(GEMM_KC, K - pc);
+            gemmPackBScaled(B + pc * ldb + jc, ldb, kc, nc, alpha, Bpack);
+            for (size_t ic = 0; ic < M; ic += GEMM_MC) {
+                const size_t mc = std::min(GEMM_MC, M - ic);
+                double* Ctile = C + ic * ldc + jc;
+                if (pc == 0 && beta != 1.0) {
+                    for (size_t i = 0; i < mc; ++i) {
+                        double* row = Ctile + i * ldc;
+                        if (beta == 0.0) {
+                            std::fill(row, row + nc, 0.0);
+                        } else {
+                            for (size_t j = 0; j < nc; ++j) {
+                                row[j] *= beta;
+                            }
+                        }
+                    }
+                }
+                gemmMicroKernel(A + ic * lda + pc, lda, Bpack,
+                                Ctile, ldc, mc, kc, nc);
+            }
+        }
+    }
+}
+
+// Dot-product kernel: two independent accumulators hide the FMA latency;
+// summed and drained with a scalar tail. Same three-tier dispatch as the
+// micro-kernels.
+static double dotKernelScalar(const double* a, const double* b, size_t n) {
+    double result = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+#ifdef MATRIX_OPS_X86
+MATRIX_OPS_TARGET("avx2,fma")
+static double dotKernelAvx2(const double* a, const double* b, size_t n) {
+    size_t i = 0;
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+MATRIX_OPS_TARGET("avx512f")
+static double dotKernelAvx512(const double* a, const double* b, size_t n) {
+    size_t i = 0;
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    }
+    double result = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+    for (; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+#endif  // MATRIX_OPS_X86
+
+static double (*pickDotKernel())(const double*, const double*, size_t) {
+#ifdef MATRIX_OPS_X86
+    if (SIMD_TIER == SimdAvx512) return dotKernelAvx512;
+    if (SIMD_TIER == SimdAvx2) return dotKernelAvx2;
+#endif
+    return dotKernelScalar;
+}
+
+static double (*const dotKernel)(const double*, const double*, size_t) =
+    pickDotKernel();
+
+// --- Float32 multiplication kernels ---
+// Same blocking scheme as the double kernels above, on float lanes: a __m256
+// holds eight floats instead of four doubles, so the register block widens to
+// 4x16 and each packed panel covers twice the columns per byte of cache. The
+// tile constants are shared; a float panel simply weighs half as much.
+static void gemmPackBF(const float* B, size_t ldb, size_t kc, size_t nc, float* Bp) {
+    for (size_t k = 0; k < kc; ++k) {
+        const float* src = B + k * ldb;
+        float* dst = Bp + k * nc;
+        for (size_t j = 0; j < nc; ++j) {
+            dst[j] = src[j];
+        }
+    }
+}
+
+static void gemmMicroKernelFScalar(const float* A, size_t lda,
+                                   const float* Bp, float* C, size_t ldc,
+                                   size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        float* c0 = C + (i + 0) * ldc;
+        float* c1 = C + (i + 1) * ldc;
+        float* c2 = C + (i + 2) * ldc;
+        float* c3 = C + (i + 3) * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const float a0 = A[(i + 0) * lda + k];
+            const float a1 = A[(i + 1) * lda + k];
+            const float a2 = A[(i + 2) * lda + k];
+            const float a3 = A[(i + 3) * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                const float bj = b[j];
+                c0[j] += a0 * bj;
+                c1[j] += a1 * bj;
+                c2[j] += a2 * bj;
+                c3[j] += a3 * bj;
+            }
+        }
+    }
+    for (; i < mr; ++i) {
+        float* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const float a = A[i * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+#ifdef MATRIX_OPS_X86
+MATRIX_OPS_TARGET("avx2,fma")
+static void gemmMicroKernelFAvx2(const float* A, size_t lda,
+                                 const float* Bp, float* C, size_t ldc,
+                                 size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        float* c0 = C + (i + 0) * ldc;
+        float* c1 = C + (i + 1) * ldc;
+        float* c2 = C + (i + 2) * ldc;
+        float* c3 = C + (i + 3) * ldc;
+        // 4x16 register block, the float analogue of the 4x8 double tile
+        size_t j = 0;
+        for (; j + 16 <= nc; j += 16) {
+            __m256 acc00 = _mm256_setzero_ps(), acc01 = _mm256_setzero_ps();
+            __m256 acc10 = _mm256_setzero_ps(), acc11 = _mm256_setzero_ps();
+            __m256 acc20 = _mm256_setzero_ps(), acc21 = _mm256_setzero_ps();
+            __m256 acc30 = _mm256_setzero_ps(), acc31 = _mm256_setzero_ps();
+            for (size_t k = 0; k < kc; ++k) {
+                const float* b = Bp + k * nc + j;
+                const __m256 b0 = _mm256_loadu_ps(b);
+                const __m256 b1 = _mm256_loadu_ps(b + 8);
+                const __m256 a0 = _mm256_broadcast_ss(A + (i + 0) * lda + k);
+                acc00 = _mm256_fmadd_ps(a0, b0, acc00);
+                acc01 = _mm256_fmadd_ps(a0, b1, acc01);
+                const __m256 a1 = _mm256_broadcast_ss(A + (i + 1) * lda + k);
+                acc10 = _mm256_fmadd_ps(a1, b0, acc10);
+                acc11 = _mm256_fmadd_ps(a1, b1, acc11);
+                const __m256 a2 = _mm256_broadcast_ss(A + (i + 2) * lda + k);
+                acc20 = _mm256_fmadd_ps(a2, b0, acc20);
+                acc21 = _mm256_fmadd_ps(a2, b1, acc21);
+                const __m256 a3 = _mm256_broadcast_ss(A + (i + 3) * lda + k);
+                acc30 = _mm256_fmadd_ps(a3, b0, acc30);
+                acc31 = _mm256_fmadd_ps(a3, b1, acc31);
+            }
+            _mm256_storeu_ps(c0 + j, _mm256_add_ps(_mm256_loadu_ps(c0 + j), acc00));
+            _mm256_storeu_ps(c0 + j + 8, _mm256_add_ps(_mm256_loadu_ps(c0 + j + 8), acc01));
+            _mm256_storeu_ps(c1 + j, _mm256_add_ps(_mm256_loadu_ps(c1 + j), acc10));
+            _mm256_storeu_ps(c1 + j + 8, _mm256_add_ps(_mm256_loadu_ps(c1 + j + 8), acc11));
+            _mm256_storeu_ps(c2 + j, _mm256_add_ps(_mm256_loadu_ps(c2 + j), acc20));
+            _mm256_storeu_ps(c2 + j + 8, _mm256_add_ps(_mm256_loadu_ps(c2 + j + 8), acc21));
+            _mm256_storeu_ps(c3 + j, _mm256_add_ps(_mm256_loadu_ps(c3 + j), acc30));
+            _mm256_storeu_ps(c3 + j + 8, _mm256_add_ps(_mm256_loadu_ps(c3 + j + 8), acc31));
+        }
+        // Remainder columns, scalar
+        for (size_t k = 0; k < kc; ++k) {
+            const float a0 = A[(i + 0) * lda + k];
+            const float a1 = A[(i + 1) * lda + k];
+            const float a2 = A[(i + 2) * lda + k];
+            const float a3 = A[(i + 3) * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t jj = j; jj < nc; ++jj) {
+                const float bj = b[jj];
+                c0[jj] += a0 * bj;
+                c1[jj] += a1 * bj;
+                c2[jj] += a2 * bj;
+                c3[jj] += a3 * bj;
+            }
+        }
+    }
+    for (; i < mr; ++i) {
+        float* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const float a = A[i * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+MATRIX_OPS_TARGET("avx512f")
+static void gemmMicroKernelFAvx512(const float* A, size_t lda,
+                                   const float* Bp, float* C, size_t ldc,
+                                   size_t mr, size_t kc, size_t nc) {
+    size_t i = 0;
+    for (; i + GEMM_MR <= mr; i += GEMM_MR) {
+        float* c0 = C + (i + 0) * ldc;
+        float* c1 = C + (i + 1) * ldc;
+        float* c2 = C + (i + 2) * ldc;
+        float* c3 = C + (i + 3) * ldc;
+        // 4x32 register block: sixteen floats per zmm lane pair
+        size_t j = 0;
+        for (; j + 32 <= nc; j += 32) {
+            __m512 acc00 = _mm512_setzero_ps(), acc01 = _mm512_setzero_ps();
+            __m512 acc10 = _mm512_setzero_ps(), acc11 = _mm512_setzero_ps();
+            __m512 acc20 = _mm512_setzero_ps(), acc21 = _mm512_setzero_ps();
+            __m512 acc30 = _mm512_setzero_ps(), acc31 = _mm512_setzero_ps();
+            for (size_t k = 0; k < kc; ++k) {
+                const float* b = Bp + k * nc + j;
+                const __m512 b0 = _mm512_loadu_ps(b);
+                const __m512 b1 = _mm512_loadu_ps(b + 16);
+                const __m512 a0 = _mm512_set1_ps(A[(i + 0) * lda + k]);
+                acc00 = _mm512_fmadd_ps(a0, b0, acc00);
+                acc01 = _mm512_fmadd_ps(a0, b1, acc01);
+                const __m512 a1 = _mm512_set1_ps(A[(i + 1) * lda + k]);
+                acc10 = _mm512_fmadd_ps(a1, b0, acc10);
+                acc11 = _mm512_fmadd_ps(a1, b1, acc11);
+                const __m512 a2 = _mm512_set1_ps(A[(i + 2) * lda + k]);
+                acc20 = _mm512_fmadd_ps(a2, b0, acc20);
+                acc21 = _mm512_fmadd_ps(a2, b1, acc21);
+                const __m512 a3 = _mm512_set1_ps(A[(i + 3) * lda + k]);
+                acc30 = _mm512_fmadd_ps(a3, b0, acc30);
+                acc31 = _mm512_fmadd_ps(a3, b1, acc31);
+            }
+            _mm512_storeu_ps(c0 + j, _mm512_add_ps(_mm512_loadu_ps(c0 + j), acc00));
+            _mm512_storeu_ps(c0 + j + 16, _mm512_add_ps(_mm512_loadu_ps(c0 + j + 16), acc01));
+            _mm512_storeu_ps(c1 + j, _mm512_add_ps(_mm512_loadu_ps(c1 + j), acc10));
+            _mm512_storeu_ps(c1 + j + 16, _mm512_add_ps(_mm512_loadu_ps(c1 + j + 16), acc11));
+            _mm512_storeu_ps(c2 + j, _mm512_add_ps(_mm512_loadu_ps(c2 + j), acc20));
+            _mm512_storeu_ps(c2 + j + 16, _mm512_add_ps(_mm512_loadu_ps(c2 + j + 16), acc21));
+            _mm512_storeu_ps(c3 + j, _mm512_add_ps(_mm512_loadu_ps(c3 + j), acc30));
+            _mm512_storeu_ps(c3 + j + 16, _mm512_add_ps(_mm512_loadu_ps(c3 + j + 16), acc31));
+        }
+        // Remainder columns, scalar
+        for (size_t k = 0; k < kc; ++k) {
+            const float a0 = A[(i + 0) * lda + k];
+            const float a1 = A[(i + 1) * lda + k];
+            const float a2 = A[(i + 2) * lda + k];
+            const float a3 = A[(i + 3) * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t jj = j; jj < nc; ++jj) {
+                const float bj = b[jj];
+                c0[jj] += a0 * bj;
+                c1[jj] += a1 * bj;
+                c2[jj] += a2 * bj;
+                c3[jj] += a3 * bj;
+            }
+        }
+    }
+    for (; i < mr; ++i) {
+        float* c = C + i * ldc;
+        for (size_t k = 0; k < kc; ++k) {
+            const float a = A[i * lda + k];
+            const float* b = Bp + k * nc;
+            for (size_t j = 0; j < nc; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+#endif  // MATRIX_OPS_X86
+
+static void (*pickGemmMicroKernelF())(const float*, size_t, const float*,
+                                      float*, size_t, size_t, size_t, size_t) {
+#ifdef MATRIX_OPS_X86
+    if (SIMD_TIER == SimdAvx512) return gemmMicroKernelFAvx512;
+    if (SIMD_TIER == SimdAvx2) return gemmMicroKernelFAvx2;
+#endif
+    return gemmMicroKernelFScalar;
+}
+
+static void (*const gemmMicroKernelF)(const float*, size_t, const float*,
+                                      float*, size_t, size_t, size_t, size_t) =
+    pickGemmMicroKernelF();
+
+// C += A * B, single precision; same contract as gemmBlocked.
+static void gemmBlockedF(const float* A, size_t lda,
+                         const float* B, size_t ldb,
+                         float* C, size_t ldc,
+                         size_t M, size_t N, size_t K) {
+    ScratchFrame scratch;
+    float* Bpack = scratch.alloc<float>(GEMM_KC * GEMM_NC);
+    for (size_t jc = 0; jc < N; jc += GEMM_NC) {
+        const size_t nc = std::min(GEMM_NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += GEMM_KC) {
+            const size_t kc = std::min(GEMM_KC, K - pc);
+            gemmPackBF(B + pc * ldb + jc, ldb, kc, nc, Bpack);
+            for (size_t ic = 0; ic < M; ic += GEMM_MC) {
+                const size_t mc = std::min(GEMM_MC, M - ic);
+                gemmMicroKernelF(A + ic * lda + pc, lda, Bpack,
+                                 C + ic * ldc + jc, ldc, mc, kc, nc);
+            }
+        }
+    }
+}
+
+// --- Strassen tier ---
+// Above a few thousand rows the classical kernel leaves asymptotic gains on
+// the table: Strassen's scheme does 7 half-size multiplies instead of 8 at
+// the cost of ~18 half-size additions per level, about a 15-25% flop saving
+// at 8192 with two levels of recursion. The recursion runs until a dimension
+// drops below the crossover or turns odd, then hands the sub-block to the
+// blocked classical kernel (parallelised across the pool at the leaves);
+// all temporaries come from the scratch arena, so the nightly giant-multiply
+// job does no steady-state allocation.
+// Thresholds are mutable and env-overridable so the recursion can be
+// exercised (and tuned) without a 2048^3 multiply; see
+// set_strassen_thresholds in the bindings.
+static size_t envSize(const char* name, size_t fallback) {
+    const char* env = std::getenv(name);
+    if (env && *env) {
+        const long v = std::strtol(env, nullptr, 10);
+        if (v > 0) {
+            return static_cast<size_t>(v);
+        }
+    }
+    return fallback;
+}
+
+static size_t STRASSEN_MIN_DIM =                // engage the tier at/above this
+    envSize("MATRIX_OPS_STRASSEN_MIN", 2048);
+static size_t STRASSEN_CROSSOVER =              // classical below this
+    envSize("MATRIX_OPS_STRASSEN_CROSSOVER", 1024);
+
+static void blockAdd(const double* x, size_t ldx,
+                     const double* y, size_t ldy,
+                     double* dst, size_t ldd, size_t r, size_t c) {
+    for (size_t i = 0; i < r; ++i) {
+        const double* xr = x + i * ldx;
+        const double* yr = y + i * ldy;
+        double* d = dst + i * ldd;
+        for (size_t j = 0; j < c; ++j) {
+            d[j] = xr[j] + yr[j];
+        }
+    }
+}
+
+static void blockSub(const double* x, size_t ldx,
+                     const double* y, size_t ldy,
+                     double* dst, size_t ldd, size_t r, size_t c) {
+    for (size_t i = 0; i < r; ++i) {
+        const double* xr = x + i * ldx;
+        const double* yr = y + i * ldy;
+        double* d = dst + i * ldd;
+        for (size_t j = 0; j < c; ++j) {
+            d[j] = xr[j] - yr[j];
+        }
+    }
+}
+
+// dst += sign * p over an r x c block
+static void blockAccum(double* dst, size_t ldd,
+                       const double* p, size_t ldp,
+                       size_t r, size_t c, double sign) {
+    for (size_t i = 0; i < r; ++i) {
+        double* d = dst + i * ldd;
+        const double* pr = p + i * ldp;
+        for (size_t j = 0; j < c; ++j) {
+            d[j] += sign * pr[j];
+        }
+    }
+}
+
+// C = A * B (C overwritten). Recursion happens on the calling thread; the
+// classical leaves fan out across the pool, so this must not itself be
+// called from a pool worker.
+static void strassenMultiply(const double* A, size_t lda,
+                             const double* B, size_t ldb,
+                             double* C, size_t ldc,
+                             size_t M, size_t N, size_t K) {
+    if (M < STRASSEN_CROSSOVER || N < STRASSEN_CROSSOVER || K < STRASSEN_CROSSOVER ||
+        (M % 2) || (N % 2) || (K % 2)) {
+        for (size_t i = 0; i < M; ++i) {
+            std::memset(C + i * ldc, 0, N * sizeof(double));
+        }
+        if (M * N * K >= PARALLEL_MIN_FLOPS && M > 1) {
+            ThreadPool::instance().parallelFor(0, M, [&](size_t r0, size_t r1) {
+                gemmBlocked(A + r0 * lda, lda, B, ldb,
+                            C + r0 * ldc, ldc, r1 - r0, N, K);
+            });
+        } else {
+            gemmBlocked(A, lda, B, ldb, C, ldc, M, N, K);
+        }
+        return;
+    }
+
+    const size_t m = M / 2, n = N / 2, k = K / 2;
+    const double* A11 = A;
+    const double* A12 = A + k;
+    const double* A21 = A + m * lda;
+    const double* A22 = A + m * lda + k;
+    const double* B11 = B;
+    const double* B12 = B + n;
+    const double* B21 = B + k * ldb;
+    const double* B22 = B + k * ldb + n;
+    double* C11 = C;
+    double* C12 = C + n;
+    double* C21 = C + m * ldc;
+    double* C22 = C + m * ldc + n;
+
+    ScratchFrame scratch;
+    double* Ta = scratch.alloc<double>(m * k);  // left-operand temporary
+    double* Tb = scratch.alloc<double>(k * n);  // right-operand temporary
+    double* P = scratch.alloc<double>(m * n);   // current product
+
+    for (size_t i = 0; i < M; ++i) {
+        std::memset(C + i * ldc, 0, N * sizeof(double));
+    }
+
+    // M1 = (A11 + A22)(B11 + B22): C11 += M1, C22 += M1
+    blockAdd(A11, lda, A22, lda, Ta, k, m, k);
+    blockAdd(B11, ldb, B22, ldb, Tb, n, k, n);
+    strassenMultiply(Ta, k, Tb, n, P, n, m, n, k);
+    blockAccum(C11, ldc, P, n, m, n, 1.0);
+    blockAccum(C22, ldc, P, n, m, n, 1.0);
+
+    // M2 = (A21 + A22) B11: C21 += M2, C22 -= M2
+    blockAdd(A21, lda, A22, lda, Ta, k, m, k);
+    strassenMultiply(Ta, k, B11, ldb, P, n, m, n, k);
+    blockAccum(C21, ldc, P, n, m, n, 1.0);
+    blockAccum(C22, ldc, P, n, m, n, -1.0);
+
+    // M3 = A11 (B12 - B22): C12 += M3, C22 += M3
+    blockSub(B12, ldb, B22, ldb, Tb, n, k, n);
+    strassenMultiply(A11, lda, Tb, n, P, n, m, n, k);
+    blockAccum(C12, ldc, P, n, m, n, 1.0);
+    blockAccum(C22, ldc, P, n, m, n, 1.0);
+
+    // M4 = A22 (B21 - B11): C11 += M4, C21 += M4
+    blockSub(B21, ldb, B11, ldb, Tb, n, k, n);
+    strassenMultiply(A22, lda, Tb, n, P, n, m, n, k);
+    blockAccum(C11, ldc, P, n, m, n, 1.0);
+    blockAccum(C21, ldc, P, n, m, n, 1.0);
+
+    // M5 = (A11 + A12) B22: C11 -= M5, C12 += M5
+    blockAdd(A11, lda, A12, lda, Ta, k, m, k);
+    strassenMultiply(Ta, k, B22, ldb, P, n, m, n, k);
+    blockAccum(C11, ldc, P, n, m, n, -1.0);
+    blockAccum(C12, ldc, P, n, m, n, 1.0);
+
+    // M6 = (A21 - A11)(B11 + B12): C22 += M6
+    blockSub(A21, lda, A11, lda, Ta, k, m, k);
+    blockAdd(B11, ldb, B12, ldb, Tb, n, k, n);
+    strassenMultiply(Ta, k, Tb, n, P, n, m, n, k);
+    blockAccum(C22, ldc, P, n, m, n, 1.0);
+
+    // M7 = (A12 - A22)(B21 + B22): C11 += M7
+    blockSub(A12, lda, A22, lda, Ta, k, m, k);
+    blockAdd(B21, ldb, B22, ldb, Tb, n, k, n);
+    strassenMultiply(Ta, k, Tb, n, P, n, m, n, k);
+    blockAccum(C11, ldc, P, n, m, n, 1.0);
+}
+
+// --- LU factorization ---
+// Factors the n x n row-major matrix `a` in place into P*A = L*U with partial
+// pivoting (L's unit diagonal is implicit; multipliers are stored below the
+// diagonal). Returns the sign of the row permutation (+1 or -1), or 0 when a
+// pivot column is numerically zero, i.e. the matrix is singular. When `ipiv`
+// is given it records, LAPACK-style, the row each step k was swapped with so
+// the permutation can be replayed onto right-hand sides.
+static int luFactorInPlace(double* a, size_t n, size_t* ipiv = nullptr) {
+    int sign = 1;
+    for (size_t k = 0; k < n; ++k) {
+        // Partial pivoting: swap in the row with the largest entry in column k
+        size_t p = k;
+        double best = std::abs(a[k * n + k]);
+        for (size_t i = k + 1; i < n; ++i) {
+            double v = std::abs(a[i * n + k]);
+            if (v > best) {
+                best = v;
+                p = i;
+            }
+        }
+        if (best < 1e-10) {
+            return 0;
+        }
+        if (ipiv) {
+            ipiv[k] = p;
+        }
+        if (p != k) {
+            for (size_t j = 0; j < n; ++j) {
+                std::swap(a[k * n + j], a[p * n + j]);
+            }
+            sign = -sign;
+        }
+        const double pivot = a[k * n + k];
+        for (size_t i = k + 1; i < n; ++i) {
+            const double m = a[i * n + k] / pivot;
+            a[i * n + k] = m;
+            for (size_t j = k + 1; j < n; ++j) {
+                a[i * n + j] -= m * a[k * n + j];
+            }
+        }
+    }
+    return sign;
+}
+
+// --- Expression templates for elementwise arithmetic ---
+// A + B - C used to mean one temporary and one full memory sweep per
+// operator. Instead, the operators below build lightweight expression nodes
+// that record the computation; nothing is evaluated until the expression is
+// assigned into a Matrix, at which point a single fused loop streams every
+// operand once and writes the result once. Expression nodes hold references
+// to their operands, so expressions must be consumed in the statement that
+// builds them (which is how the bindings and all internal callers use them).
+template <typename E>
+struct MatExpr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+struct AddOp {
+    static double apply(double a, double b) { return a + b; }
+};
+struct SubOp {
+    static double apply(double a, double b) { return a - b; }
+};
+struct MulOp {  // elementwise (Hadamard) product
+    static double apply(double a, double b) { return a * b; }
+};
+
+template <typename L, typename R, typename Op>
+struct BinaryExpr : MatExpr<BinaryExpr<L, R, Op>> {
+    const L& lhs;
+    const R& rhs;
+    BinaryExpr(const L& l, const R& r) : lhs(l), rhs(r) {
+        if (l.exprRows() != r.exprRows() || l.exprCols() != r.exprCols()) {
+            throw std::invalid_argument("Matrix dimensions don't match for elementwise operation");
+        }
+    }
+    size_t exprRows() const { return lhs.exprRows(); }
+    size_t exprCols() const { return lhs.exprCols(); }
+    double exprAt(size_t i) const { return Op::apply(lhs.exprAt(i), rhs.exprAt(i)); }
+};
+
+template <typename E>
+struct ScaledExpr : MatExpr<ScaledExpr<E>> {
+    const E& inner;
+    double scale;
+    ScaledExpr(const E& e, double s) : inner(e), scale(s) {}
+    size_t exprRows() const { return inner.exprRows(); }
+    size_t exprCols() const { return inner.exprCols(); }
+    double exprAt(size_t i) const { return scale * inner.exprAt(i); }
+};
+
+template <typename L, typename R>
+BinaryExpr<L, R, AddOp> operator+(const MatExpr<L>& a, const MatExpr<R>& b) {
+    return BinaryExpr<L, R, AddOp>(a.self(), b.self());
+}
+
+template <typename L, typename R>
+BinaryExpr<L, R, SubOp> operator-(const MatExpr<L>& a, const MatExpr<R>& b) {
+    return BinaryExpr<L, R, SubOp>(a.self(), b.self());
+}
+
+template <typename L, typename R>
+BinaryExpr<L, R, MulOp> hadamard(const MatExpr<L>& a, const MatExpr<R>& b) {
+    return BinaryExpr<L, R, MulOp>(a.self(), b.self());
+}
+
+template <typename E>
+ScaledExpr<E> operator*(const MatExpr<E>& a, double s) {
+    return ScaledExpr<E>(a.self(), s);
+}
+
+template <typename E>
+ScaledExpr<E> operator*(double s, const MatExpr<E>& a) {
+    return ScaledExpr<E>(a.self(), s);
+}
+
+// --- Gauss-Jordan inversion core ---
+// Inverts the n x n row-major matrix `src` into `dst` (which may alias src).
+// The augmented [A|I] working matrix comes from the thread's scratch arena,
+// so repeated inversions reuse the same warm pages. Returns false when the
+// matrix is singular. `parallel` lets the elimination step fan out across
+// the pool; callers already running on pool workers must pass false to
+// avoid nesting.
+static bool gaussJordanInvert(const double* src, double* dst, size_t n, bool parallel) {
+    const size_t w = 2 * n;
+    ScratchFrame scratch;
+    double* aug = scratch.alloc<double>(n * w);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            aug[i * w + j] = src[i * n + j];
+            aug[i * w + j + n] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        // Swap in the row with the largest entry in column i
+        size_t p = i;
+        double best = std::abs(aug[i * w + i]);
+        for (size_t k = i + 1; k < n; ++k) {
+            double v = std::abs(aug[k * w + i]);
+            if (v > best) {
+                best = v;
+                p = k;
+            }
+        }
+        if (best < 1e-10) {
+            return false;
+        }
+        if (p != i) {
+            for (size_t j = 0; j < w; ++j) {
+                std::swap(aug[i * w + j], aug[p * w + j]);
+            }
+        }
+        double pivot = aug[i * w + i];
+
+        // Scale row
+        for (size_t j = 0; j < w; ++j) {
+            aug[i * w + j] /= pivot;
+        }
+
+        // Eliminate column; every row update is independent, so large
+        // eliminations split the row range across the pool.
+        auto eliminate = [&](size_t k0, size_t k1) {
+            for (size_t k = k0; k < k1; ++k) {
+                if (k == i) continue;
+                double factor = aug[k * w + i];
+                for (size_t j = 0; j < w; ++j) {
+                    aug[k * w + j] -= factor * aug[i * w + j];
+                }
+            }
+        };
+        if (parallel && n * w * 2 >= PARALLEL_MIN_FLOPS) {
+            ThreadPool::instance().parallelFor(0, n, eliminate);
+        } else {
+            eliminate(0, n);
+        }
+    }
+
+    // Extract inverse matrix
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            dst[i * n + j] = aug[i * w + j + n];
+        }
+    }
+    return true;
+}
+
+// C = A * B^T: every output element is a unit-stride dot product of an A row
+// with a B row, which is exactly the access pattern the hardware prefetchers
+// want. Used by multiply() when the right operand is a transpose view.
+static void gemmABt(const double* A, size_t lda,
+                    const double* B, size_t ldb,
+                    double* C, size_t ldc,
+                    size_t M, size_t N, size_t K) {
+    for (size_t i = 0; i < M; ++i) {
+        const double* arow = A + i * lda;
+        double* crow = C + i * ldc;
+        for (size_t j = 0; j < N; ++j) {
+            crow[j] = dotKernel(arow, B + j * ldb, K);
+        }
+    }
+}
+
+// C = A^T * B with A stored K x M: a rank-1 accumulation per k keeps both
+// the B row and the C rows unit-stride, so the transpose never materializes.
+static void gemmAtB(const double* A, size_t lda,
+                    const double* B, size_t ldb,
+                    double* C, size_t ldc,
+                    size_t M, size_t N, size_t K) {
+    for (size_t i = 0; i < M; ++i) {
+        double* crow = C + i * ldc;
+        for (size_t j = 0; j < N; ++j) {
+            crow[j] = 0.0;
+        }
+    }
+    for (size_t k = 0; k < K; ++k) {
+        const double* brow = B + k * ldb;
+        for (size_t i = 0; i < M; ++i) {
+            const double f = A[k * lda + i];
+            if (f == 0.0) continue;
+            double* crow = C + i * ldc;
+            for (size_t j = 0; j < N; ++j) {
+                crow[j] += f * brow[j];
+            }
+        }
+    }
+}
+
+// --- Strided vector views ---
+// Non-owning view of n elements a fixed stride apart: a matrix row
+// (stride 1) or column (stride = row length) without copying either.
+// dot() runs the SIMD kernel when both sides are contiguous and a plain
+// strided loop otherwise.
+class VectorView {
+public:
+    VectorView(const double* base, size_t stride, size_t n)
+        : base(base), stride(stride), n(n) {}
+
+    size_t size() const { return n; }
+    double at(size_t i) const { return base[i * stride]; }
+
+    std::vector<double> toVector() const {
+        std::vector<double> out(n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = base[i * stride];
+        }
+        return out;
+    }
+
+    double dot(const VectorView& other) const {
+        if (n != other.n) {
+            throw std::invalid_argument("Vectors must have the same dimension");
+        }
+        if (stride == 1 && other.stride == 1) {
+            return dotKernel(base, other.base, n);
+        }
+        double result = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            result += base[i * stride] * other.base[i * other.stride];
+        }
+        return result;
+    }
+
+private:
+    const double* base;
+    size_t stride;
+    size_t n;
+};
+
+class LUDecomposition;
+class CholeskyDecomposition;
+class QRDecomposition;
+class SymmetricEigen;
+class TransposeView;
+class MatrixView;
+class AsyncMatrixResult;
+
+class Matrix : public MatExpr<Matrix> {
+private:
+    // Single contiguous row-major buffer: element (i, j) lives at
+    // store[i * cols + j]. Keeping every element in one allocation means rows
+    // share cache lines and the hot loops below walk memory linearly instead
+    // of chasing a pointer per row. The buffer sits behind a shared_ptr:
+    // copies share it and a writer clones it first (copy-on-write, see
+    // detach), so fanning a 2GB matrix out to five read-only consumers costs
+    // five pointers, not five buffers.
+    std::shared_ptr<std::vector<double>> store;
+    size_t rows, cols;
+    // Set once a long-lived raw pointer into the buffer has been handed out
+    // (strided views, numpy(), the buffer protocol). From then on copies go
+    // back to eager deep copies and this matrix never detaches, so the
+    // outstanding pointers keep aliasing it; see exportData().
+    bool exported;
+
+    // Clone the buffer if any other matrix shares it. Every mutating entry
+    // point funnels through here (via rawData()/mut()) before writing.
+    void detach() {
+        if (store.use_count() > 1) {
+            store = std::make_shared<std::vector<double>>(*store);
+        }
+    }
+
+    // Writable buffer reference for methods that grew up on a plain vector
+    std::vector<double>& mut() {
+        detach();
+        return *store;
+    }
+
+    const std::vector<double>& ro() const { return *store; }
+
+public:
+    Matrix(size_t r, size_t c)
+        : store(std::make_shared<std::vector<double>>(r * c, 0.0)),
+          rows(r), cols(c), exported(false) {}
+
+    Matrix(const std::vector<std::vector<double>>& input)
+        : store(std::make_shared<std::vector<double>>()), exported(false) {
+        rows = input.size();
+        cols = input[0].size();
+        std::vector<double>& data = *store;
+        data.reserve(rows * cols);
+        for (const auto& row : input) {
+            if (row.size() != cols) {
+                throw std::invalid_argument("All rows must have the same length");
+            }
+            data.insert(data.end(), row.begin(), row.end());
+        }
+    }
+
+    // Adopt an existing flat row-major buffer without copying: the vector's
+    // allocation becomes the matrix storage. This is the cheap way in from
+    // anything that already has the data laid out flat.
+    Matrix(size_t r, size_t c, std::vector<double>&& flat)
+        : store(std::make_shared<std::vector<double>>(std::move(flat))),
+          rows(r), cols(c), exported(false) {
+        if (store->size() != r * c) {
+            throw std::invalid_argument("Flat buffer size doesn't match dimensions");
+        }
+    }
+
+    // Copies share the buffer (copy-on-write) unless the source has exported
+    // raw pointers, in which case they deep-copy so the pointers keep
+    // aliasing their matrix. Moves steal the buffer; the moved-from matrix
+    // is left as a valid 0x0 so its shape always matches its storage.
+    Matrix(const Matrix& other)
+        : store(other.exported
+                    ? std::make_shared<std::vector<double>>(*other.store)
+                    : other.store),
+          rows(other.rows), cols(other.cols), exported(false) {}
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) {
+            store = other.exported
+                        ? std::make_shared<std::vector<double>>(*other.store)
+                        : other.store;
+            rows = other.rows;
+            cols = other.cols;
+            exported = false;
+        }
+        return *this;
+    }
+    Matrix(Matrix&& other) noexcept
+        : store(std::move(other.store)), rows(other.rows), cols(other.cols),
+          exported(other.exported) {
+        other.store = std::make_shared<std::vector<double>>();
+        other.rows = 0;
+        other.cols = 0;
+        other.exported = false;
+    }
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            store = std::move(other.store);
+            rows = other.rows;
+            cols = other.cols;
+            exported = other.exported;
+            other.store = std::make_shared<std::vector<double>>();
+            other.rows = 0;
+            other.cols = 0;
+            other.exported = false;
+        }
+        return *this;
+    }
+
+    // Construct from a NumPy array (or anything convertible to one). The
+    // forcecast handle gives us a dense row-major float64 view, which is
+    // loaded with one bulk copy instead of a per-element Python conversion.
+    Matrix(const py::array_t<double, py::array::c_style | py::array::forcecast>& input)
+        : store(std::make_shared<std::vector<double>>()), exported(false) {
+        py::buffer_info info = input.request();
+        if (info.ndim != 2) {
+            throw std::invalid_argument("Matrix requires a 2-dimensional array");
+        }
+        rows = static_cast<size_t>(info.shape[0]);
+        cols = static_cast<size_t>(info.shape[1]);
+        store->resize(rows * cols);
+        std::memcpy(store->data(), info.ptr, rows * cols * sizeof(double));
+    }
+
+    // Access elements; the writable form detaches from sharing copies
+    double& operator()(size_t i, size_t j) {
+        return mut()[i * cols + j];
+    }
+
+    const double& operator()(size_t i, size_t j) const {
+        return ro()[i * cols + j];
+    }
+
+    // Evaluate an expression tree: the whole right-hand side collapses into
+    // one pass over the flat buffer, however many operators built it.
+    template <typename E>
+    Matrix(const MatExpr<E>& e)
+        : store(std::make_shared<std::vector<double>>(
+              e.self().exprRows() * e.self().exprCols())),
+          rows(e.self().exprRows()), cols(e.self().exprCols()),
+          exported(false) {
+        evalExpr(e.self());
+    }
+
+    template <typename E>
+    Matrix& operator=(const MatExpr<E>& e) {
+        const E& x = e.self();
+        rows = x.exprRows();
+        cols = x.exprCols();
+        mut().resize(rows * cols);
+        evalExpr(x);
+        return *this;
+    }
+
+    // Expression-node interface (flat elementwise access)
+    size_t exprRows() const { return rows; }
+    size_t exprCols() const { return cols; }
+    double exprAt(size_t i) const { return ro()[i]; }
+
+    // Direct access to the contiguous buffer for the kernels below
+    double* rawData() { return mut().data(); }
+    const double* rawData() const { return ro().data(); }
+
+    // Raw pointer that outlives the call (views, numpy, buffer protocol):
+    // detach so no sharing copy can pull the buffer away, then pin so this
+    // matrix never detaches away from the pointer either.
+    double* exportData() {
+        detach();
+        exported = true;
+        return store->data();
+    }
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+
+    // Copying accessor, kept for callers that want an independent snapshot.
+    // numpy() and the buffer protocol are the zero-copy ways to read the data.
+    std::vector<std::vector<double>> getData() const {
+        const std::vector<double>& data = ro();
+        std::vector<std::vector<double>> out(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            out[i].assign(data.begin() + i * cols, data.begin() + (i + 1) * cols);
+        }
+        return out;
+    }
+
+    void save(const std::string& path) const;
+
+    // Matrix multiplication
+    Matrix multiply(const Matrix& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        
+        Matrix result(rows, other.cols);
+        PerfCounters::local().addAlloc(PerfCounters::OpMultiply);
+        multiplyInto(other, result);
+        return result;
+    }
+
+    // Allocation-free multiply: writes this * other into a caller-owned
+    // output matrix of the right shape. `out` must not alias either operand.
+    void multiplyInto(const Matrix& other, Matrix& out) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        if (&out == this || &out == &other) {
+            throw std::invalid_argument("multiply_into output must not alias an operand");
+        }
+        if (out.rows != rows || out.cols != other.cols) {
+            throw std::invalid_argument("Output matrix has wrong dimensions");
+        }
+
+        PerfScope perf(PerfCounters::OpMultiply,
+                       2ull * rows * other.cols * cols,
+                       (rows * cols + cols * other.cols + rows * other.cols) * sizeof(double));
+        std::vector<double>& cvec = out.mut();
+        std::fill(cvec.begin(), cvec.end(), 0.0);
+        const double* A = rawData();
+        const double* B = other.rawData();
+        double* C = out.rawData();
+        const size_t N = other.cols;
+        // Very large multiplies take the Strassen tier: 7 sub-multiplies per
+        // level instead of 8, with the classical kernel at the leaves.
+        if (rows >= STRASSEN_MIN_DIM && N >= STRASSEN_MIN_DIM && cols >= STRASSEN_MIN_DIM) {
+            strassenMultiply(A, cols, B, N, C, N, rows, N, cols);
+            return;
+        }
+        // Rows of C are independent, so large multiplies split the row range
+        // across the pool; each worker runs the blocked kernel on its slice
+        // with its own pack buffer.
+        if (rows * N * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+                gemmBlocked(A + r0 * cols, cols, B, N,
+                            C + r0 * N, N, r1 - r0, N, cols);
+            });
+        } else {
+            gemmBlocked(A, cols, B, N, C, N, rows, N, cols);
+        }
+    }
+
+    // Determinant (via LU factorization with partial pivoting): O(n^3) and a
+    // single working copy, instead of the O(n!) cofactor expansion this class
+    // used to ship. det(A) = sign(P) * product of U's diagonal.
+    double determinant() const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square for determinant");
+        }
+
+        if (rows == 1) return ro()[0];
+        if (rows == 2) return (*this)(0, 0) * (*this)(1, 1) - (*this)(0, 1) * (*this)(1, 0);
+
+        PerfScope perf(PerfCounters::OpDeterminant,
+                       2ull * rows * rows * rows / 3,
+                       static_cast<uint64_t>(rows) * rows * sizeof(double));
+        ScratchFrame scratch;
+        double* lu = scratch.alloc<double>(rows * rows);
+        std::memcpy(lu, rawData(), rows * rows * sizeof(double));
+        int sign = luFactorInPlace(lu, rows);
+        if (sign == 0) {
+            return 0.0;
+        }
+        double det = sign;
+        for (size_t k = 0; k < rows; ++k) {
+            det *= lu[k * rows + k];
+        }
+        return det;
+    }
+    
+    // Out-of-place transpose, tiled so both source and destination touch
+    // whole cache lines within each 32x32 block instead of striding a full
+    // row apart on every element.
+    Matrix transpose() const {
+        Matrix t(cols, rows);
+        const size_t TB = 32;
+        const double* src = rawData();
+        double* dst = t.rawData();
+        auto body = [&](size_t ii0, size_t ii1) {
+            for (size_t ii = ii0; ii < ii1; ii += TB) {
+                const size_t iEnd = std::min(ii + TB, ii1);
+                for (size_t jj = 0; jj < cols; jj += TB) {
+                    const size_t jEnd = std::min(jj + TB, cols);
+                    for (size_t i = ii; i < iEnd; ++i) {
+                        for (size_t j = jj; j < jEnd; ++j) {
+                            dst[j * rows + i] = src[i * cols + j];
+                        }
+                    }
+                }
+            }
+        };
+        if (rows * cols >= PARALLEL_MIN_FLOPS && rows > TB) {
+            // Chunk on tile boundaries so workers never share a tile row
+            const size_t tileRows = (rows + TB - 1) / TB;
+            ThreadPool::instance().parallelFor(0, tileRows, [&](size_t t0, size_t t1) {
+                body(t0 * TB, std::min(t1 * TB, rows));
+            });
+        } else {
+            body(0, rows);
+        }
+        return t;
+    }
+
+    // --- Reductions ---
+    // Convergence-check aggregates as native reductions over the flat
+    // buffer: one linear pass each, split across the pool when the matrix
+    // is large enough to be worth the handoff. Partial results fold under
+    // a mutex -- the fold runs once per worker, not once per element.
+
+    // Frobenius norm: sqrt of the self-dot, via the SIMD dot kernel.
+    double norm() const {
+        const double* a = rawData();
+        const size_t n = rows * cols;
+        if (n >= PARALLEL_MIN_FLOPS) {
+            double sum = 0.0;
+            std::mutex fold;
+            ThreadPool::instance().parallelFor(0, n, [&](size_t i0, size_t i1) {
+                const double s = dotKernel(a + i0, a + i0, i1 - i0);
+                std::lock_guard<std::mutex> lock(fold);
+                sum += s;
+            });
+            return std::sqrt(sum);
+        }
+        return std::sqrt(dotKernel(a, a, n));
+    }
+
+    double trace() const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square for trace");
+        }
+        double sum = 0.0;
+        for (size_t k = 0; k < rows; ++k) {
+            sum += ro()[k * cols + k];
+        }
+        return sum;
+    }
+
+    double maxAbs() const {
+        const double* a = rawData();
+        const size_t n = rows * cols;
+        auto rangeMax = [&](size_t i0, size_t i1) {
+            double best = 0.0;
+            for (size_t i = i0; i < i1; ++i) {
+                const double v = std::abs(a[i]);
+                if (v > best) best = v;
+            }
+            return best;
+        };
+        if (n >= PARALLEL_MIN_FLOPS) {
+            double best = 0.0;
+            std::mutex fold;
+            ThreadPool::instance().parallelFor(0, n, [&](size_t i0, size_t i1) {
+                const double b = rangeMax(i0, i1);
+                std::lock_guard<std::mutex> lock(fold);
+                if (b > best) best = b;
+            });
+            return best;
+        }
+        return rangeMax(0, n);
+    }
+
+    // Row sums are independent linear passes, one output element per row.
+    std::vector<double> rowSums() const {
+        std::vector<double> out(rows, 0.0);
+        auto body = [&](size_t r0, size_t r1) {
+            for (size_t i = r0; i < r1; ++i) {
+                const double* row = rawData() + i * cols;
+                double sum = 0.0;
+                for (size_t j = 0; j < cols; ++j) {
+                    sum += row[j];
+                }
+                out[i] = sum;
+            }
+        };
+        if (rows * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, body);
+        } else {
+            body(0, rows);
+        }
+        return out;
+    }
+
+    // Column sums sweep row-wise (unit stride) into a per-worker
+    // accumulator, folded at the end; striding down columns would miss
+    // cache on every element.
+    std::vector<double> colSums() const {
+        std::vector<double> out(cols, 0.0);
+        if (rows * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            std::mutex fold;
+            ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+                std::vector<double> local(cols, 0.0);
+                for (size_t i = r0; i < r1; ++i) {
+                    const double* row = rawData() + i * cols;
+                    for (size_t j = 0; j < cols; ++j) {
+                        local[j] += row[j];
+                    }
+                }
+                std::lock_guard<std::mutex> lock(fold);
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] += local[j];
+                }
+            });
+        } else {
+            for (size_t i = 0; i < rows; ++i) {
+                const double* row = rawData() + i * cols;
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] += row[j];
+                }
+            }
+        }
+        return out;
+    }
+
+    // Zero-cost transpose view; see TransposeView below.
+    TransposeView T() const;
+
+    // Strided non-owning view of a sub-block; see MatrixView below.
+    MatrixView block(size_t i, size_t j, size_t r, size_t c);
+
+    // Row/column vector views over the flat storage: a row is contiguous,
+    // a column strides by the row length. No elements are copied. The
+    // storage is pinned first so the view keeps tracking this matrix even
+    // if it has been copied.
+    VectorView rowView(size_t i) {
+        if (i >= rows) {
+            throw std::invalid_argument("Row index out of range");
+        }
+        return VectorView(exportData() + i * cols, 1, cols);
+    }
+
+    VectorView colView(size_t j) {
+        if (j >= cols) {
+            throw std::invalid_argument("Column index out of range");
+        }
+        return VectorView(exportData() + j, cols, rows);
+    }
+
+    // A * B^T without materializing the transpose
+    Matrix multiply(const TransposeView& otherT) const;
+
+    // Factor once, solve many times; see LUDecomposition below.
+    LUDecomposition lu() const;
+
+    // Cholesky factorization for symmetric positive-definite matrices;
+    // see CholeskyDecomposition below.
+    CholeskyDecomposition cholesky() const;
+
+    // Householder QR for tall systems; see QRDecomposition below.
+    QRDecomposition qr() const;
+
+    // Symmetric eigendecomposition (full, and a top-k fast path);
+    // see SymmetricEigen below.
+    SymmetricEigen eigh() const;
+    SymmetricEigen topKEigen(size_t k) const;
+
+    // Convenience: solve A x = b without forming A^-1. One factorization,
+    // one pair of triangular sweeps — half the flops of inverse-then-multiply.
+    std::vector<double> solve(const std::vector<double>& b) const;
+
+    // Convenience: least-squares solution of the tall system A x = b via
+    // one QR pass -- no normal equations, no squared condition number.
+    std::vector<double> lstsq(const std::vector<double>& b) const;
+
+    // Matrix inverse (using Gauss-Jordan elimination)
+    Matrix inverse() const {
+        Matrix inv(rows, cols);
+        PerfCounters::local().addAlloc(PerfCounters::OpInverse);
+        inverseInto(inv);
+        return inv;
+    }
+
+    // Allocation-free inverse in steady state: the working storage lives in a
+    // thread-local scratch buffer that is reused across calls, so repeated
+    // same-shaped inversions never touch the heap. `out` may alias *this
+    // (A is copied into scratch before out is written).
+    void inverseInto(Matrix& out) const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square for inverse");
+        }
+        if (out.rows != rows || out.cols != cols) {
+            throw std::invalid_argument("Output matrix has wrong dimensions");
+        }
+
+        PerfScope perf(PerfCounters::OpInverse,
+                       2ull * rows * rows * rows,
+                       2ull * rows * rows * sizeof(double));
+        // Singularity is detected by the pivot search during elimination;
+        // a separate determinant() pre-check would redo the same O(n^3) work.
+        if (!gaussJordanInvert(rawData(), out.rawData(), rows, true)) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+    }
+
+    // Asynchronous variants: start the computation on a background thread
+    // and return a handle immediately; see AsyncMatrixResult below.
+    AsyncMatrixResult multiplyAsync(const Matrix& other) const;
+    AsyncMatrixResult inverseAsync() const;
+
+private:
+    template <typename E>
+    void evalExpr(const E& x) {
+        double* out = mut().data();
+        auto body = [&](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; ++i) {
+                out[i] = x.exprAt(i);
+            }
+        };
+        const size_t n = rows * cols;
+        if (n >= PARALLEL_MIN_FLOPS) {
+            ThreadPool::instance().parallelFor(0, n, body);
+        } else {
+            body(0, n);
+        }
+    }
+};
+
+// --- Lazy transpose view ---
+// A.T() costs nothing: it records "treat A as transposed" and multiply()
+// picks the kernel whose memory access suits that orientation, so A^T * B
+// and A * B^T run straight off the original row-major storage. eval()
+// materializes via the blocked transpose when an actual Matrix is needed.
+// The view references its base matrix; the bindings keep the base alive for
+// the lifetime of the view.
+class TransposeView {
+public:
+    explicit TransposeView(const Matrix& m) : src(m) {}
+
+    size_t getRows() const { return src.getCols(); }
+    size_t getCols() const { return src.getRows(); }
+    const Matrix& base() const { return src; }
+
+    Matrix eval() const { return src.transpose(); }
+
+    // A^T * B
+    Matrix multiply(const Matrix& other) const {
+        if (src.getRows() != other.getRows()) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        const size_t M = src.getCols();
+        const size_t N = other.getCols();
+        const size_t K = src.getRows();
+        Matrix result(M, N);
+        const double* A = src.rawData();
+        const double* B = other.rawData();
+        double* C = result.rawData();
+        if (M * N * K >= PARALLEL_MIN_FLOPS && M > 1) {
+            ThreadPool::instance().parallelFor(0, M, [&](size_t i0, size_t i1) {
+                gemmAtB(A + i0, M, B, N, C + i0 * N, N, i1 - i0, N, K);
+            });
+        } else {
+            gemmAtB(A, M, B, N, C, N, M, N, K);
+        }
+        return result;
+    }
+
+private:
+    const Matrix& src;
+};
+
+inline TransposeView Matrix::T() const {
+    return TransposeView(*this);
+}
+
+inline Matrix Matrix::multiply(const TransposeView& otherT) const {
+    const Matrix& b = otherT.base();
+    if (cols != b.getCols()) {
+        throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+    }
+    const size_t N = b.getRows();
+    Matrix result(rows, N);
+    const double* A = rawData();
+    const double* B = b.rawData();
+    double* C = result.rawData();
+    if (rows * N * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+        ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+            gemmABt(A + r0 * cols, cols, B, cols, C + r0 * N, N, r1 - r0, N, cols);
+        });
+    } else {
+        gemmABt(A, cols, B, cols, C, N, rows, N, cols);
+    }
+    return result;
+}
+
+// --- Strided block views ---
+// block(i, j, r, c) addresses an r x c window of a matrix in place: the view
+// keeps a pointer into the parent's flat storage plus the parent's row
+// length as its leading dimension. The GEMM kernels already take leading
+// dimensions, so a view multiplies straight out of the parent's memory --
+// no copy to touch a diagonal block of a 10k x 10k matrix. Writes through
+// assign()/set() land in the parent. The bindings keep the parent alive for
+// the view's lifetime.
+class MatrixView {
+public:
+    MatrixView(Matrix& m, size_t i, size_t j, size_t r, size_t c)
+        : base(m.exportData() + i * m.getCols() + j), ld(m.getCols()),
+          rows(r), cols(c) {}
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+
+    double at(size_t i, size_t j) const { return base[i * ld + j]; }
+    void set(size_t i, size_t j, double v) { base[i * ld + j] = v; }
+
+    // Materialize a contiguous copy
+    Matrix eval() const {
+        Matrix out(rows, cols);
+        double* dst = out.rawData();
+        for (size_t i = 0; i < rows; ++i) {
+            std::memcpy(dst + i * cols, base + i * ld, cols * sizeof(double));
+        }
+        return out;
+    }
+
+    // Overwrite the block with src's elements (writes into the parent)
+    void assign(const Matrix& src) {
+        if (src.getRows() != rows || src.getCols() != cols) {
+            throw std::invalid_argument("Matrix dimensions don't match for assignment");
+        }
+        const double* s = src.rawData();
+        for (size_t i = 0; i < rows; ++i) {
+            std::memcpy(base + i * ld, s + i * cols, cols * sizeof(double));
+        }
+    }
+
+    // this * other, reading both operands through their strides
+    Matrix multiply(const Matrix& other) const {
+        return multiplyCommon(other.rawData(), other.getRows(),
+                              other.getCols(), other.getCols());
+    }
+
+    Matrix multiply(const MatrixView& other) const {
+        return multiplyCommon(other.base, other.rows, other.cols, other.ld);
+    }
+
+    // Determinant of a square block: one contiguous working copy in the
+    // scratch arena, then the usual LU.
+    double determinant() const {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix must be square for determinant");
+        }
+        ScratchFrame scratch;
+        double* lu = scratch.alloc<double>(rows * rows);
+        for (size_t i = 0; i < rows; ++i) {
+            std::memcpy(lu + i * rows, base + i * ld, rows * sizeof(double));
+        }
+        int sign = luFactorInPlace(lu, rows);
+        if (sign == 0) {
+            return 0.0;
+        }
+        double det = sign;
+        for (size_t k = 0; k < rows; ++k) {
+            det *= lu[k * rows + k];
+        }
+        return det;
+    }
+
+    VectorView rowView(size_t i) const {
+        if (i >= rows) {
+            throw std::invalid_argument("Row index out of range");
+        }
+        return VectorView(base + i * ld, 1, cols);
+    }
+
+    VectorView colView(size_t j) const {
+        if (j >= cols) {
+            throw std::invalid_argument("Column index out of range");
+        }
+        return VectorView(base + j, ld, rows);
+    }
+
+private:
+    Matrix multiplyCommon(const double* B, size_t brows, size_t bcols,
+                          size_t ldb) const {
+        if (cols != brows) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        Matrix result(rows, bcols);
+        double* C = result.rawData();
+        if (rows * bcols * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+                gemmBlocked(base + r0 * ld, ld, B, ldb,
+                            C + r0 * bcols, bcols, r1 - r0, bcols, cols);
+            });
+        } else {
+            gemmBlocked(base, ld, B, ldb, C, bcols, rows, bcols, cols);
+        }
+        return result;
+    }
+
+    double* base;
+    size_t ld;
+    size_t rows, cols;
+};
+
+inline MatrixView Matrix::block(size_t i, size_t j, size_t r, size_t c) {
+    if (i + r > rows || j + c > cols || r == 0 || c == 0) {
+        throw std::invalid_argument("Block extends outside the matrix");
+    }
+    return MatrixView(*this, i, j, r, c);
+}
+
+// --- LU factorization handle ---
+// One O(n^3) factorization that amortizes across any number of O(n^2)
+// solves. The handle owns the packed L/U factors (L's unit diagonal is
+// implicit) and the pivot record, so solving against hundreds of right-hand
+// sides never refactors — and never forms an explicit inverse.
+class LUDecomposition {
+public:
+    explicit LUDecomposition(const Matrix& a)
+        : n(a.getRows()),
+          lu(a.rawData(), a.rawData() + a.getRows() * a.getCols()),
+          ipiv(a.getRows()), sign(0) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Matrix must be square for LU factorization");
+        }
+        sign = luFactorInPlace(lu.data(), n, ipiv.data());
+    }
+
+    bool isSingular() const { return sign == 0; }
+
+    double det() const {
+        if (sign == 0) return 0.0;
+        double d = sign;
+        for (size_t k = 0; k < n; ++k) {
+            d *= lu[k * n + k];
+        }
+        return d;
+    }
+
+    // Solve A x = b: permute, then one forward and one back substitution.
+    std::vector<double> solve(const std::vector<double>& b) const {
+        if (b.size() != n) {
+            throw std::invalid_argument("Right-hand side has wrong length for solve");
+        }
+        requireNonSingular();
+        std::vector<double> x(b);
+        for (size_t k = 0; k < n; ++k) {
+            std::swap(x[k], x[ipiv[k]]);
+        }
+        // Forward substitution with unit-diagonal L
+        for (size_t i = 1; i < n; ++i) {
+            x[i] -= dotKernel(&lu[i * n], x.data(), i);
+        }
+        // Back substitution with U
+        for (size_t i = n; i-- > 0;) {
+            double s = x[i];
+            for (size_t j = i + 1; j < n; ++j) {
+                s -= lu[i * n + j] * x[j];
+            }
+            x[i] = s / lu[i * n + i];
+        }
+        return x;
+    }
+
+    // Solve A X = B for a whole block of right-hand sides; the substitution
+    // sweeps run across full rows of B so the inner loops stay unit-stride.
+    Matrix solveMatrix(const Matrix& B) const {
+        if (B.getRows() != n) {
+            throw std::invalid_argument("Matrix dimensions don't match for solve");
+        }
+        requireNonSingular();
+        Matrix X(B);
+        const size_t m = B.getCols();
+        double* x = X.rawData();
+        for (size_t k = 0; k < n; ++k) {
+            if (ipiv[k] != k) {
+                for (size_t j = 0; j < m; ++j) {
+                    std::swap(x[k * m + j], x[ipiv[k] * m + j]);
+                }
+            }
+        }
+        // Forward substitution with unit-diagonal L
+        for (size_t i = 1; i < n; ++i) {
+            double* dst = x + i * m;
+            for (size_t j = 0; j < i; ++j) {
+                const double f = lu[i * n + j];
+                if (f == 0.0) continue;
+                const double* src = x + j * m;
+                for (size_t c = 0; c < m; ++c) {
+                    dst[c] -= f * src[c];
+                }
+            }
+        }
+        // Back substitution with U
+        for (size_t i = n; i-- > 0;) {
+            double* dst = x + i * m;
+            for (size_t j = i + 1; j < n; ++j) {
+                const double f = lu[i * n + j];
+                const double* src = x + j * m;
+                for (size_t c = 0; c < m; ++c) {
+                    dst[c] -= f * src[c];
+                }
+            }
+            const double inv = 1.0 / lu[i * n + i];
+            for (size_t c = 0; c < m; ++c) {
+                dst[c] *= inv;
+            }
+        }
+        return X;
+    }
+
+    // Explicit inverse when one is genuinely needed: solve against I.
+    Matrix inverse() const {
+        requireNonSingular();
+        Matrix identity(n, n);
+        for (size_t k = 0; k < n; ++k) {
+            identity(k, k) = 1.0;
+        }
+        return solveMatrix(identity);
+    }
+
+private:
+    void requireNonSingular() const {
+        if (sign == 0) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+    }
+
+    size_t n;
+    std::vector<double> lu;
+    std::vector<size_t> ipiv;
+    int sign;
+};
+
+inline LUDecomposition Matrix::lu() const {
+    return LUDecomposition(*this);
+}
+
+inline std::vector<double> Matrix::solve(const std::vector<double>& b) const {
+    return lu().solve(b);
+}
+
+// --- Cholesky factorization handle ---
+// For symmetric positive-definite matrices (covariances, Gram matrices):
+// A = L L^T at half the flops of LU, no pivoting, and the factorization
+// touches only the lower triangle. logdet() sums logs of the diagonal
+// instead of multiplying n pivots, so it doesn't overflow where
+// determinant() on a 1000x1000 covariance does.
+class CholeskyDecomposition {
+public:
+    explicit CholeskyDecomposition(const Matrix& a)
+        : n(a.getRows()),
+          fac(a.rawData(), a.rawData() + a.getRows() * a.getCols()),
+          spd(false) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Matrix must be square for Cholesky factorization");
+        }
+        spd = factor();
+    }
+
+    bool isSpd() const { return spd; }
+
+    // log(det(A)) = 2 * sum(log(L_kk)); stays finite long after the
+    // determinant itself has left double range.
+    double logdet() const {
+        requireSpd();
+        double s = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            s += std::log(fac[k * n + k]);
+        }
+        return 2.0 * s;
+    }
+
+    // Solve A x = b: forward substitution with L, back substitution with L^T.
+    std::vector<double> solve(const std::vector<double>& b) const {
+        if (b.size() != n) {
+            throw std::invalid_argument("Right-hand side has wrong length for solve");
+        }
+        requireSpd();
+        std::vector<double> x(b);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = (x[i] - dotKernel(&fac[i * n], x.data(), i)) / fac[i * n + i];
+        }
+        for (size_t i = n; i-- > 0;) {
+            double s = x[i];
+            for (size_t k = i + 1; k < n; ++k) {
+                s -= fac[k * n + i] * x[k];
+            }
+            x[i] = s / fac[i * n + i];
+        }
+        return x;
+    }
+
+    // Block solve A X = B, sweeping full rows of B so the inner loops
+    // stay unit-stride.
+    Matrix solveMatrix(const Matrix& B) const {
+        if (B.getRows() != n) {
+            throw std::invalid_argument("Matrix dimensions don't match for solve");
+        }
+        requireSpd();
+        Matrix X(B);
+        const size_t m = B.getCols();
+        double* x = X.rawData();
+        // Forward substitution with L
+        for (size_t i = 0; i < n; ++i) {
+            double* dst = x + i * m;
+            for (size_t j = 0; j < i; ++j) {
+                const double f = fac[i * n + j];
+                if (f == 0.0) continue;
+                const double* src = x + j * m;
+                for (size_t c = 0; c < m; ++c) {
+                    dst[c] -= f * src[c];
+                }
+            }
+            const double inv = 1.0 / fac[i * n + i];
+            for (size_t c = 0; c < m; ++c) {
+                dst[c] *= inv;
+            }
+        }
+        // Back substitution with L^T (read L down its columns)
+        for (size_t i = n; i-- > 0;) {
+            double* dst = x + i * m;
+            for (size_t k = i + 1; k < n; ++k) {
+                const double f = fac[k * n + i];
+                if (f == 0.0) continue;
+                const double* src = x + k * m;
+                for (size_t c = 0; c < m; ++c) {
+                    dst[c] -= f * src[c];
+                }
+            }
+            const double inv = 1.0 / fac[i * n + i];
+            for (size_t c = 0; c < m; ++c) {
+                dst[c] *= inv;
+            }
+        }
+        return X;
+    }
+
+    // Explicit inverse when one is genuinely needed: solve against I.
+    Matrix inverse() const {
+        requireSpd();
+        Matrix identity(n, n);
+        for (size_t k = 0; k < n; ++k) {
+            identity(k, k) = 1.0;
+        }
+        return solveMatrix(identity);
+    }
+
+private:
+    // Row-major Cholesky-Crout: L rows are built left to right, so every
+    // inner product runs over two contiguous row prefixes and goes through
+    // the SIMD dot kernel. Only the lower triangle is read or written.
+    bool factor() {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                const double s = fac[i * n + j] -
+                                 dotKernel(&fac[i * n], &fac[j * n], j);
+                fac[i * n + j] = s / fac[j * n + j];
+            }
+            const double d = fac[i * n + i] -
+                             dotKernel(&fac[i * n], &fac[i * n], i);
+            if (d <= 0.0 || !std::isfinite(d)) {
+                return false;
+            }
+            fac[i * n + i] = std::sqrt(d);
+        }
+        return true;
+    }
+
+    void requireSpd() const {
+        if (!spd) {
+            throw std::invalid_argument("Matrix is not positive definite");
+        }
+    }
+
+    size_t n;
+    std::vector<double> fac;
+    bool spd;
+};
+
+inline CholeskyDecomposition Matrix::cholesky() const {
+    return CholeskyDecomposition(*this);
+}
+
+// --- QR factorization handle ---
+// Householder QR for tall systems (rows >= cols): one pass over A gives
+// A = Q R, and lstsq() solves min ||A x - b|| straight from the factors.
+// Unlike the normal-equations route (A^T A, then inverse) this never
+// squares the condition number and never forms a rows x rows intermediate.
+// Storage is compact LAPACK-style: R in the upper triangle, each Householder
+// vector (unit leading entry implied) below the diagonal, its scalar in tau.
+class QRDecomposition {
+public:
+    explicit QRDecomposition(const Matrix& a)
+        : m(a.getRows()), n(a.getCols()),
+          fac(a.rawData(), a.rawData() + a.getRows() * a.getCols()),
+          tau(a.getCols(), 0.0), fullRank(true) {
+        if (m < n) {
+            throw std::invalid_argument("QR requires at least as many rows as columns");
+        }
+        factor();
+    }
+
+    bool isFullRank() const { return fullRank; }
+
+    // Upper-triangular factor (cols x cols)
+    Matrix r() const {
+        Matrix R(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i; j < n; ++j) {
+                R(i, j) = fac[i * n + j];
+            }
+        }
+        return R;
+    }
+
+    // Thin orthogonal factor (rows x cols), built by applying the reflectors
+    // to the identity in reverse order. O(m n^2) -- only materialize Q when
+    // Q itself is wanted; lstsq() never does.
+    Matrix q() const {
+        Matrix Q(m, n);
+        for (size_t k = 0; k < n; ++k) {
+            Q(k, k) = 1.0;
+        }
+        for (size_t k = n; k-- > 0;) {
+            applyReflector(k, Q.rawData(), n, 0, n);
+        }
+        return Q;
+    }
+
+    // Least-squares solution of A x = b: y = Q^T b by applying the
+    // reflectors in order, then back substitution with R on the top n rows.
+    std::vector<double> lstsq(const std::vector<double>& b) const {
+        if (b.size() != m) {
+            throw std::invalid_argument("Right-hand side has wrong length for lstsq");
+        }
+        requireFullRank();
+        std::vector<double> y(b);
+        for (size_t k = 0; k < n; ++k) {
+            double w = y[k];
+            for (size_t i = k + 1; i < m; ++i) {
+                w += fac[i * n + k] * y[i];
+            }
+            w *= tau[k];
+            y[k] -= w;
+            for (size_t i = k + 1; i < m; ++i) {
+                y[i] -= w * fac[i * n + k];
+            }
+        }
+        std::vector<double> x(y.begin(), y.begin() + n);
+        for (size_t i = n; i-- > 0;) {
+            double s = x[i];
+            for (size_t j = i + 1; j < n; ++j) {
+                s -= fac[i * n + j] * x[j];
+            }
+            x[i] = s / fac[i * n + i];
+        }
+        return x;
+    }
+
+    // Least squares for a whole block of right-hand sides. Columns of B are
+    // independent, so each reflector application splits the column range
+    // across the pool; the sweeps run along rows to stay unit-stride.
+    Matrix lstsqMatrix(const Matrix& B) const {
+        if (B.getRows() != m) {
+            throw std::invalid_argument("Matrix dimensions don't match for lstsq");
+        }
+        requireFullRank();
+        Matrix Y(B);
+        const size_t p = B.getCols();
+        double* y = Y.rawData();
+        for (size_t k = 0; k < n; ++k) {
+            auto body = [&](size_t j0, size_t j1) {
+                applyReflector(k, y, p, j0, j1);
+            };
+            if (2 * (m - k) * p >= PARALLEL_MIN_FLOPS && p > 1) {
+                ThreadPool::instance().parallelFor(0, p, body);
+            } else {
+                body(0, p);
+            }
+        }
+        // X = R^{-1} * (top n rows of Y), back substitution across full rows
+        Matrix X(n, p);
+        double* x = X.rawData();
+        std::memcpy(x, y, n * p * sizeof(double));
+        for (size_t i = n; i-- > 0;) {
+            double* dst = x + i * p;
+            for (size_t j = i + 1; j < n; ++j) {
+                const double f = fac[i * n + j];
+                if (f == 0.0) continue;
+                const double* src = x + j * p;
+                for (size_t c = 0; c < p; ++c) {
+                    dst[c] -= f * src[c];
+                }
+            }
+            const double inv = 1.0 / fac[i * n + i];
+            for (size_t c = 0; c < p; ++c) {
+                dst[c] *= inv;
+            }
+        }
+        return X;
+    }
+
+private:
+    void factor() {
+        for (size_t k = 0; k < n; ++k) {
+            // Householder vector for column k over the trailing rows
+            double normsq = 0.0;
+            for (size_t i = k; i < m; ++i) {
+                const double v = fac[i * n + k];
+                normsq += v * v;
+            }
+            const double norm = std::sqrt(normsq);
+            if (norm == 0.0) {
+                // Zero column: identity reflector, rank deficiency recorded
+                fullRank = false;
+                tau[k] = 0.0;
+                continue;
+            }
+            const double alpha = fac[k * n + k];
+            const double beta = alpha >= 0.0 ? -norm : norm;
+            tau[k] = (beta - alpha) / beta;
+            const double scale = 1.0 / (alpha - beta);
+            for (size_t i = k + 1; i < m; ++i) {
+                fac[i * n + k] *= scale;
+            }
+            fac[k * n + k] = beta;
+            // Trailing update A[k:, k+1:] -= tau v (v^T A[k:, k+1:]).
+            // Trailing columns are independent, so large updates split the
+            // column range across the pool.
+            if (k + 1 >= n) {
+                continue;
+            }
+            auto body = [&](size_t j0, size_t j1) {
+                applyReflector(k, fac.data(), n, j0, j1);
+            };
+            if (2 * (m - k) * (n - k - 1) >= PARALLEL_MIN_FLOPS && n - k - 1 > 1) {
+                ThreadPool::instance().parallelFor(k + 1, n, body);
+            } else {
+                body(k + 1, n);
+            }
+        }
+    }
+
+    // Apply reflector k to columns [j0, j1) of the m-row buffer C with
+    // leading dimension ldc: C -= tau v (v^T C), touching rows k..m-1 only.
+    // Two row sweeps (gather w = v^T C, then the rank-1 subtraction) keep
+    // the inner loops unit-stride; w lives in the per-thread scratch arena.
+    void applyReflector(size_t k, double* C, size_t ldc, size_t j0, size_t j1) const {
+        const size_t nj = j1 - j0;
+        ScratchFrame scratch;
+        double* w = scratch.alloc<double>(nj);
+        const double* top = C + k * ldc + j0;
+        for (size_t j = 0; j < nj; ++j) {
+            w[j] = top[j];
+        }
+        for (size_t i = k + 1; i < m; ++i) {
+            const double vi = fac[i * n + k];
+            if (vi == 0.0) continue;
+            const double* row = C + i * ldc + j0;
+            for (size_t j = 0; j < nj; ++j) {
+                w[j] += vi * row[j];
+            }
+        }
+        const double t = tau[k];
+        for (size_t j = 0; j < nj; ++j) {
+            w[j] *= t;
+        }
+        double* dst = C + k * ldc + j0;
+        for (size_t j = 0; j < nj; ++j) {
+            dst[j] -= w[j];
+        }
+        for (size_t i = k + 1; i < m; ++i) {
+            const double vi = fac[i * n + k];
+            if (vi == 0.0) continue;
+            double* row = C + i * ldc + j0;
+            for (size_t j = 0; j < nj; ++j) {
+                row[j] -= w[j] * vi;
+            }
+        }
+    }
+
+    void requireFullRank() const {
+        if (!fullRank) {
+            throw std::invalid_argument("Matrix is rank deficient");
+        }
+    }
+
+    size_t m, n;
+    std::vector<double> fac;
+    std::vector<double> tau;
+    bool fullRank;
+};
+
+inline QRDecomposition Matrix::qr() const {
+    return QRDecomposition(*this);
+}
+
+inline std::vector<double> Matrix::lstsq(const std::vector<double>& b) const {
+    return qr().lstsq(b);
+}
+
+// --- Symmetric eigensolver ---
+// Spectral decomposition of symmetric matrices (covariances, Gram and
+// Laplacian matrices) without round-tripping the whole matrix to NumPy.
+// Two routes: the full decomposition runs cyclic Jacobi sweeps in place on
+// a working copy -- unconditionally stable and exact for the moderate sizes
+// where all n pairs are wanted -- and top-k uses blocked subspace iteration,
+// where all the O(n^2 k) work is gemm through the threaded multiply path, so
+// pulling the leading 32 components of a 10k x 10k covariance never touches
+// the O(n^3) full solve. Eigenvalues come back descending (PCA order) with
+// one eigenvector per column.
+class SymmetricEigen {
+public:
+    // Full decomposition. The working copy is symmetrized up front
+    // ((A + A^T) / 2), so covariances that are symmetric only to roundoff
+    // don't feed the sweeps inconsistent triangles.
+    explicit SymmetricEigen(const Matrix& a)
+        : vals(a.getRows()), vecs(a.getRows(), a.getRows()) {
+        const size_t n = a.getRows();
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Matrix must be square for eigendecomposition");
+        }
+        std::vector<double> w(n * n);
+        const double* src = a.rawData();
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                w[i * n + j] = 0.5 * (src[i * n + j] + src[j * n + i]);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            vecs(i, i) = 1.0;
+        }
+        jacobiSweeps(w.data(), n);
+        sortDescending(w.data(), n);
+    }
+
+    // Leading k eigenpairs by subspace iteration: V <- orth(A V) until the
+    // Ritz estimates settle, then one Rayleigh-Ritz projection (a k x k
+    // Jacobi solve) recombines the basis into eigenvectors. Converges on
+    // the eigenvalues largest in magnitude -- the right end for the
+    // positive-semidefinite matrices PCA feeds it.
+    SymmetricEigen(const Matrix& a, size_t k)
+        : vals(k), vecs(a.getRows(), k) {
+        const size_t n = a.getRows();
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Matrix must be square for eigendecomposition");
+        }
+        if (k == 0 || k > n) {
+            throw std::invalid_argument("top_k_eigen requires 0 < k <= matrix dimension");
+        }
+        // Deterministic pseudo-random start, orthonormalized by one QR
+        Matrix V(n, k);
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < k; ++j) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                V(i, j) = static_cast<double>(state >> 11) *
+                          (1.0 / 9007199254740992.0) - 0.5;
+            }
+        }
+        V = QRDecomposition(V).q();
+
+        std::vector<double> prev(k, 0.0);
+        for (size_t iter = 0; iter < 500; ++iter) {
+            Matrix W = a.multiply(V);
+            QRDecomposition qr(W);
+            V = qr.q();
+            // |R_ii| estimates |lambda_i|; stop when the estimates settle
+            Matrix R = qr.r();
+            double worst = 0.0;
+            for (size_t j = 0; j < k; ++j) {
+                const double est = std::fabs(R(j, j));
+                const double change = std::fabs(est - prev[j]) /
+                                      (est > 1.0 ? est : 1.0);
+                worst = std::max(worst, change);
+                prev[j] = est;
+            }
+            if (iter > 0 && worst <= 1e-12) {
+                break;
+            }
+        }
+
+        // Rayleigh-Ritz: eigenpairs of the projected k x k problem lift
+        // back through the converged basis
+        Matrix W = a.multiply(V);
+        Matrix B = V.T().multiply(W);
+        SymmetricEigen small(B);
+        vals = small.vals;
+        vecs = V.multiply(small.vecs);
+    }
+
+    // Eigenvalues, descending
+    const std::vector<double>& values() const { return vals; }
+
+    // One eigenvector per column, matching values()
+    const Matrix& vectors() const { return vecs; }
+
+private:
+    // Cyclic Jacobi: sweep every (p, q) pair, rotating a_pq to zero and
+    // accumulating the rotations into vecs, until the off-diagonal mass is
+    // gone. Each rotation is O(n), a sweep O(n^3); a handful of sweeps
+    // converges quadratically.
+    void jacobiSweeps(double* w, size_t n) {
+        for (size_t sweep = 0; sweep < 64; ++sweep) {
+            double off = 0.0;
+            double frob = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    const double v = w[i * n + j];
+                    frob += v * v;
+                    if (i != j) {
+                        off += v * v;
+                    }
+                }
+            }
+            if (off <= 1e-30 * (frob > 0.0 ? frob : 1.0)) {
+                return;
+            }
+            for (size_t p = 0; p + 1 < n; ++p) {
+                for (size_t q = p + 1; q < n; ++q) {
+                    const double apq = w[p * n + q];
+                    if (apq == 0.0) {
+                        continue;
+                    }
+                    const double app = w[p * n + p];
+                    const double aqq = w[q * n + q];
+                    if (std::fabs(apq) <=
+                        1e-18 * (std::fabs(app) + std::fabs(aqq))) {
+                        w[p * n + q] = w[q * n + p] = 0.0;
+                        continue;
+                    }
+                    const double theta = (aqq - app) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                                     (std::fabs(theta) +
+                                      std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0);
+                    const double s = t * c;
+                    for (size_t i = 0; i < n; ++i) {
+                        if (i == p || i == q) {
+                            continue;
+                        }
+                        const double aip = w[i * n + p];
+                        const double aiq = w[i * n + q];
+                        w[i * n + p] = w[p * n + i] = c * aip - s * aiq;
+                        w[i * n + q] = w[q * n + i] = s * aip + c * aiq;
+                    }
+                    w[p * n + p] = app - t * apq;
+                    w[q * n + q] = aqq + t * apq;
+                    w[p * n + q] = w[q * n + p] = 0.0;
+                    for (size_t i = 0; i < n; ++i) {
+                        const double vip = vecs(i, p);
+                        const double viq = vecs(i, q);
+                        vecs(i, p) = c * vip - s * viq;
+                        vecs(i, q) = s * vip + c * viq;
+                    }
+                }
+            }
+        }
+    }
+
+    // Sort eigenpairs by value, descending, permuting vector columns to match
+    void sortDescending(const double* w, size_t n) {
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return w[a * n + a] > w[b * n + b];
+        });
+        Matrix sorted(n, n);
+        for (size_t j = 0; j < n; ++j) {
+            vals[j] = w[order[j] * n + order[j]];
+            for (size_t i = 0; i < n; ++i) {
+                sorted(i, j) = vecs(i, order[j]);
+            }
+        }
+        vecs = std::move(sorted);
+    }
+
+    std::vector<double> vals;
+    Matrix vecs;
+};
+
+inline SymmetricEigen Matrix::eigh() const {
+    return SymmetricEigen(*this);
+}
+
+inline SymmetricEigen Matrix::topKEigen(size_t k) const {
+    return SymmetricEigen(*this, k);
+}
+
+// --- Asynchronous execution ---
+// multiply_async()/inverse_async() start the computation immediately and
+// return a handle, so Python can launch several independent operations and
+// overlap them with I/O instead of blocking inside each call. Each launch
+// uses std::async with its own thread rather than a pool worker: the kernel
+// itself fans out over the shared pool via parallelFor, so the async thread
+// only orchestrates and the per-launch thread cost is negligible next to
+// the math. Shape errors are raised at launch time; errors from inside the
+// kernel (e.g. a singular matrix) surface from get().
+class AsyncMatrixResult {
+public:
+    explicit AsyncMatrixResult(std::future<Matrix> f) {
+        state.reset(new State());
+        state->pending = f.share();
+    }
+
+    // True once the computation has finished (successfully or not);
+    // never blocks.
+    bool done() const {
+        return sharedCopy().wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+    }
+
+    // Block until the computation finishes and return its result; repeated
+    // calls return the same matrix. An exception thrown by the kernel is
+    // rethrown on every call, and the handle stays usable after a failure
+    // (done() keeps answering, get() keeps raising the same error).
+    const Matrix& get() const {
+        return sharedCopy().get();
+    }
+
+private:
+    // Shared so the handle stays cheaply copyable. A shared_future keeps
+    // the result (or the kernel's exception) alive across get() calls,
+    // unlike a plain future, which a throwing get() would leave invalid.
+    struct State {
+        std::shared_future<Matrix> pending;
+        std::mutex mutex;
+    };
+    std::shared_ptr<State> state;
+
+    // Threads may only share a shared_future through their own copies, so
+    // done()/get() each take one under the mutex and then wait on the copy;
+    // a blocking get() never holds the lock against a concurrent done().
+    std::shared_future<Matrix> sharedCopy() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->pending;
+    }
+};
+
+inline AsyncMatrixResult Matrix::multiplyAsync(const Matrix& other) const {
+    // Validate eagerly so a bad shape raises at the call site, not at get().
+    if (cols != other.rows) {
+        throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+    }
+    // Captured by pointer: the bindings keep both operand objects alive for
+    // the lifetime of the handle. Mutating an operand before get() is a race.
+    const Matrix* a = this;
+    const Matrix* b = &other;
+    return AsyncMatrixResult(std::async(std::launch::async, [a, b]() {
+        return a->multiply(*b);
+    }));
+}
+
+inline AsyncMatrixResult Matrix::inverseAsync() const {
+    if (rows != cols) {
+        throw std::invalid_argument("Matrix must be square for inverse");
+    }
+    const Matrix* a = this;
+    return AsyncMatrixResult(std::async(std::launch::async, [a]() {
+        return a->inverse();
+    }));
+}
+
+// --- Planned pipelines ---
+// For a fixed-shape op sequence that runs thousands of times a second, the
+// generic entry points pay per call for things that never change: dimension
+// checks, output allocation, kernel selection and a Python round-trip per
+// op. A Pipeline does all of that once at build time -- inputs and ops are
+// declared up front, every shape is validated then, and each operation gets
+// a pre-allocated output buffer -- so execute() is one Python call that runs
+// the whole recorded sequence against warm buffers. Slot ids returned by
+// the builder name inputs and intermediate results; result(slot) reads an
+// output without copying.
+class Pipeline {
+public:
+    Pipeline() : numInputs(0), bound(nullptr) {}
+
+    // Declare an execute-time input of fixed shape. All inputs must be
+    // declared before the first operation.
+    size_t input(size_t rows, size_t cols) {
+        if (!steps.empty()) {
+            throw std::invalid_argument("Pipeline inputs must be declared before operations");
+        }
+        if (rows == 0 || cols == 0) {
+            throw std::invalid_argument("Input shape must be non-empty");
+        }
+        slotRows.push_back(rows);
+        slotCols.push_back(cols);
+        ++numInputs;
+        return slotRows.size() - 1;
+    }
+
+    size_t multiply(size_t a, size_t b) {
+        checkSlot(a);
+        checkSlot(b);
+        if (slotCols[a] != slotRows[b]) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        return addStep(Step::Multiply, a, b, slotRows[a], slotCols[b]);
+    }
+
+    size_t add(size_t a, size_t b) { return elementwise(Step::Add, a, b); }
+    size_t subtract(size_t a, size_t b) { return elementwise(Step::Subtract, a, b); }
+
+    size_t inverse(size_t a) {
+        checkSlot(a);
+        if (slotRows[a] != slotCols[a]) {
+            throw std::invalid_argument("Matrix must be square for inverse");
+        }
+        return addStep(Step::Inverse, a, a, slotRows[a], slotCols[a]);
+    }
+
+    // Dot product of two vector-shaped slots (1 x n or n x 1); the scalar
+    // lands in a 1x1 result slot.
+    size_t dot(size_t a, size_t b) {
+        checkSlot(a);
+        checkSlot(b);
+        if ((slotRows[a] != 1 && slotCols[a] != 1) ||
+            (slotRows[b] != 1 && slotCols[b] != 1)) {
+            throw std::invalid_argument("dot operands must be vector-shaped");
+        }
+        if (slotRows[a] * slotCols[a] != slotRows[b] * slotCols[b]) {
+            throw std::invalid_argument("Vectors must have the same dimension");
+        }
+        return addStep(Step::Dot, a, b, 1, 1);
+    }
+
+    // Run the recorded sequence. Only the input shapes are re-checked (they
+    // guard memory safety); everything else was settled at build time.
+    void execute(const std::vector<const Matrix*>& inputs) {
+        if (inputs.size() != numInputs) {
+            throw std::invalid_argument("Pipeline expects a different number of inputs");
+        }
+        for (size_t i = 0; i < numInputs; ++i) {
+            if (inputs[i]->getRows() != slotRows[i] || inputs[i]->getCols() != slotCols[i]) {
+                throw std::invalid_argument("Input shape doesn't match the pipeline plan");
+            }
+        }
+        bound = &inputs;
+        for (const Step& s : steps) {
+            run(s);
+        }
+        bound = nullptr;
+    }
+
+    // Read an operation's output in place; no copy per frame.
+    const Matrix& result(size_t slot) const {
+        checkSlot(slot);
+        if (slot < numInputs) {
+            throw std::invalid_argument("result() takes an operation output, not an input");
+        }
+        return buffers[slot - numInputs];
+    }
+
+private:
+    struct Step {
+        enum Kind { Multiply, Add, Subtract, Inverse, Dot } kind;
+        size_t a, b, out;
+    };
+
+    void checkSlot(size_t s) const {
+        if (s >= slotRows.size()) {
+            throw std::invalid_argument("Unknown pipeline slot");
+        }
+    }
+
+    size_t elementwise(Step::Kind kind, size_t a, size_t b) {
+        checkSlot(a);
+        checkSlot(b);
+        if (slotRows[a] != slotRows[b] || slotCols[a] != slotCols[b]) {
+            throw std::invalid_argument("Matrix dimensions don't match");
+        }
+        return addStep(kind, a, b, slotRows[a], slotCols[a]);
+    }
+
+    size_t addStep(Step::Kind kind, size_t a, size_t b, size_t rows, size_t cols) {
+        slotRows.push_back(rows);
+        slotCols.push_back(cols);
+        buffers.emplace_back(rows, cols);
+        Step s;
+        s.kind = kind;
+        s.a = a;
+        s.b = b;
+        s.out = slotRows.size() - 1;
+        steps.push_back(s);
+        return s.out;
+    }
+
+    const Matrix& slot(size_t s) const {
+        return s < numInputs ? *(*bound)[s] : buffers[s - numInputs];
+    }
+
+    void run(const Step& s) {
+        const Matrix& A = slot(s.a);
+        Matrix& out = buffers[s.out - numInputs];
+        double* C = out.rawData();
+        const size_t n = out.getRows() * out.getCols();
+        switch (s.kind) {
+        case Step::Multiply: {
+            const Matrix& B = slot(s.b);
+            const size_t M = A.getRows(), K = A.getCols(), N = B.getCols();
+            std::fill(C, C + n, 0.0);
+            if (M * N * K >= PARALLEL_MIN_FLOPS && M > 1) {
+                ThreadPool::instance().parallelFor(0, M, [&](size_t r0, size_t r1) {
+                    gemmBlocked(A.rawData() + r0 * K, K, B.rawData(), N,
+                                C + r0 * N, N, r1 - r0, N, K);
+                });
+            } else {
+                gemmBlocked(A.rawData(), K, B.rawData(), N, C, N, M, N, K);
+            }
+            break;
+        }
+        case Step::Add: {
+            const double* a = A.rawData();
+            const double* b = slot(s.b).rawData();
+            for (size_t i = 0; i < n; ++i) C[i] = a[i] + b[i];
+            break;
+        }
+        case Step::Subtract: {
+            const double* a = A.rawData();
+            const double* b = slot(s.b).rawData();
+            for (size_t i = 0; i < n; ++i) C[i] = a[i] - b[i];
+            break;
+        }
+        case Step::Inverse:
+            if (!gaussJordanInvert(A.rawData(), C, A.getRows(), true)) {
+                throw std::invalid_argument("Matrix is singular");
+            }
+            break;
+        case Step::Dot:
+            C[0] = dotKernel(A.rawData(), slot(s.b).rawData(),
+                             A.getRows() * A.getCols());
+            break;
+        }
+    }
+
+    std::vector<size_t> slotRows, slotCols;
+    std::vector<Step> steps;
+    std::vector<Matrix> buffers;  // one pre-allocated output per step
+    size_t numInputs;
+    const std::vector<const Matrix*>* bound;  // inputs, valid during execute()
+};
+
+// --- Fixed-size small matrices ---
+// For 2x2..4x4 transforms the dynamic Matrix pays a heap allocation and
+// variable-bound loops on every operation. SmallMatrix keeps its elements in
+// a std::array on the stack, so multiply is a fully unrolled constant-bound
+// loop nest and determinant/inverse are the closed-form expressions — zero
+// allocations anywhere. Closed-form kernels live in SmallLinalg<N>
+// specializations; only N <= 4 is provided (and bound into Python), which is
+// exactly the regime where closed forms beat elimination.
+template <size_t N> struct SmallLinalg;
+
+template <> struct SmallLinalg<1> {
+    static double det(const double* a) { return a[0]; }
+    static void inv(const double* a, double invdet, double* b) {
+        (void)a;
+        b[0] = invdet;
+    }
+};
+
+template <> struct SmallLinalg<2> {
+    static double det(const double* a) {
+        return a[0] * a[3] - a[1] * a[2];
+    }
+    static void inv(const double* a, double invdet, double* b) {
+        b[0] =  a[3] * invdet;
+        b[1] = -a[1] * invdet;
+        b[2] = -a[2] * invdet;
+        b[3] =  a[0] * invdet;
+    }
+};
+
+template <> struct SmallLinalg<3> {
+    static double det(const double* a) {
+        return a[0] * (a[4] * a[8] - a[5] * a[7])
+             - a[1] * (a[3] * a[8] - a[5] * a[6])
+             + a[2] * (a[3] * a[7] - a[4] * a[6]);
+    }
+    static void inv(const double* a, double invdet, double* b) {
+        b[0] =  (a[4] * a[8] - a[5] * a[7]) * invdet;
+        b[1] = -(a[1] * a[8] - a[2] * a[7]) * invdet;
+        b[2] =  (a[1] * a[5] - a[2] * a[4]) * invdet;
+        b[3] = -(a[3] * a[8] - a[5] * a[6]) * invdet;
+        b[4] =  (a[0] * a[8] - a[2] * a[6]) * invdet;
+        b[5] = -(a[0] * a[5] - a[2] * a[3]) * invdet;
+        b[6] =  (a[3] * a[7] - a[4] * a[6]) * invdet;
+        b[7] = -(a[0] * a[7] - a[1] * a[6]) * invdet;
+        b[8] =  (a[0] * a[4] - a[1] * a[3]) * invdet;
+    }
+};
+
+template <> struct SmallLinalg<4> {
+    // Laplace expansion over the first two rows: six 2x2 minors from the top
+    // half (s) paired with six from the bottom half (c).
+    static double det(const double* a) {
+        double s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5;
+        minors(a, s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5);
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+    static void inv(const double* a, double invdet, double* b) {
+        double s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5;
+        minors(a, s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5);
+        b[0]  = ( a[5] * c5 - a[6] * c4 + a[7] * c3) * invdet;
+        b[1]  = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * invdet;
+        b[2]  = ( a[13] * s5 - a[14] * s4 + a[15] * s3) * invdet;
+        b[3]  = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * invdet;
+        b[4]  = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * invdet;
+        b[5]  = ( a[0] * c5 - a[2] * c2 + a[3] * c1) * invdet;
+        b[6]  = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * invdet;
+        b[7]  = ( a[8] * s5 - a[10] * s2 + a[11] * s1) * invdet;
+        b[8]  = ( a[4] * c4 - a[5] * c2 + a[7] * c0) * invdet;
+        b[9]  = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * invdet;
+        b[10] = ( a[12] * s4 - a[13] * s2 + a[15] * s0) * invdet;
+        b[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * invdet;
+        b[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * invdet;
+        b[13] = ( a[0] * c3 - a[1] * c1 + a[2] * c0) * invdet;
+        b[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * invdet;
+        b[15] = ( a[8] * s3 - a[9] * s1 + a[10] * s0) * invdet;
+    }
+
+private:
+    static void minors(const double* a,
+                       double& s0, double& s1, double& s2,
+                       double& s3, double& s4, double& s5,
+                       double& c0, double& c1, double& c2,
+                       double& c3, double& c4, double& c5) {
+        s0 = a[0] * a[5] - a[1] * a[4];
+        s1 = a[0] * a[6] - a[2] * a[4];
+        s2 = a[0] * a[7] - a[3] * a[4];
+        s3 = a[1] * a[6] - a[2] * a[5];
+        s4 = a[1] * a[7] - a[3] * a[5];
+        s5 = a[2] * a[7] - a[3] * a[6];
+        c5 = a[10] * a[15] - a[11] * a[14];
+        c4 = a[9] * a[15] - a[11] * a[13];
+        c3 = a[9] * a[14] - a[10] * a[13];
+        c2 = a[8] * a[15] - a[11] * a[12];
+        c1 = a[8] * a[14] - a[10] * a[12];
+        c0 = a[8] * a[13] - a[9] * a[12];
+    }
+};
+
+template <size_t N, size_t M>
+class SmallMatrix {
+private:
+    std::array<double, N * M> data;
+
+public:
+    SmallMatrix() : data{} {}
+
+    SmallMatrix(const std::vector<std::vector<double>>& input) : data{} {
+        if (input.size() != N) {
+            throw std::invalid_argument("Input has wrong number of rows");
+        }
+        for (size_t i = 0; i < N; ++i) {
+            if (input[i].size() != M) {
+                throw std::invalid_argument("Input has wrong number of columns");
+            }
+            for (size_t j = 0; j < M; ++j) {
+                data[i * M + j] = input[i][j];
+            }
+        }
+    }
+
+    double& operator()(size_t i, size_t j) { return data[i * M + j]; }
+    const double& operator()(size_t i, size_t j) const { return data[i * M + j]; }
+
+    size_t getRows() const { return N; }
+    size_t getCols() const { return M; }
+
+    std::vector<std::vector<double>> getData() const {
+        std::vector<std::vector<double>> out(N, std::vector<double>(M));
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < M; ++j) {
+                out[i][j] = data[i * M + j];
+            }
+        }
+        return out;
+    }
+
+    // Constant trip counts: the compiler unrolls the whole nest, so a 3x3
+    // multiply compiles down to straight-line multiply-adds.
+    template <size_t P>
+    SmallMatrix<N, P> multiply(const SmallMatrix<M, P>& other) const {
+        SmallMatrix<N, P> result;
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t k = 0; k < M; ++k) {
+                const double a = (*this)(i, k);
+                for (size_t j = 0; j < P; ++j) {
+                    result(i, j) += a * other(k, j);
+                }
+            }
+        }
+        return result;
+    }
+
+    template <size_t NN = N, typename = typename std::enable_if<NN == M>::type>
+    double determinant() const {
+        return SmallLinalg<N>::det(data.data());
+    }
+
+    template <size_t NN = N, typename = typename std::enable_if<NN == M>::type>
+    SmallMatrix<N, N> inverse() const {
+        const double det = SmallLinalg<N>::det(data.data());
+        if (std::abs(det) < 1e-10) {
+            throw std::invalid_argument("Matrix is singular");
+        }
+        SmallMatrix<N, N> result;
+        SmallLinalg<N>::inv(data.data(), 1.0 / det, &result(0, 0));
+        return result;
+    }
+};
+
+// Vector operations
+std::vector<double> dotProduct(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("Vectors must have same size for dot product");
+    }
+
+    return {dotKernel(a.data(), b.data(), a.size())};
+}
+
+std::vector<double> crossProduct(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != 3 || b.size() != 3) {
+        throw std::invalid_argument("Cross product only defined for 3D vectors");
+    }
+    
+    return {
+        a[1] * b[2] - a[2] * b[1],
+        a[2] * b[0] - a[0] * b[2],
+        a[0] * b[1] - a[1] * b[0]
+    };
+}
+
+// Canonical BLAS-3 entry point: C = alpha*A*B + beta*C, accumulated in
+// place inside the blocked kernel. The multiply-then-add pattern (fresh
+// result matrix, then a second full pass over C) becomes a single pass
+// with no intermediate allocation.
+void gemm(const Matrix& a, const Matrix& b, Matrix& c, double alpha, double beta) {
+    if (a.getCols() != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+    }
+    if (&c == &a || &c == &b) {
+        throw std::invalid_argument("gemm output must not alias an operand");
+    }
+    if (c.getRows() != a.getRows() || c.getCols() != b.getCols()) {
+        throw std::invalid_argument("Output matrix has wrong dimensions");
+    }
+
+    const size_t M = a.getRows();
+    const size_t N = b.getCols();
+    const size_t K = a.getCols();
+    PerfScope perf(PerfCounters::OpMultiply, 2ull * M * N * K,
+                   (M * K + K * N + 2 * M * N) * sizeof(double));
+    const double* A = a.rawData();
+    const double* B = b.rawData();
+    double* C = c.rawData();
+    // Same row-split parallelization as multiplyInto: rows of C are
+    // independent, including their beta scaling.
+    if (M * N * K >= PARALLEL_MIN_FLOPS && M > 1) {
+        ThreadPool::instance().parallelFor(0, M, [&](size_t r0, size_t r1) {
+            gemmBlockedScaled(A + r0 * K, K, B, N, C + r0 * N, N,
+                              r1 - r0, N, K, alpha, beta);
+        });
+    } else {
+        gemmBlockedScaled(A, K, B, N, C, N, M, N, K, alpha, beta);
+    }
+}
+
+// --- Persisted matrix files ---
+// Flat binary format for large precomputed matrices: a fixed header with
+// magic, dtype and shape, then the raw row-major payload. Loading goes
+// through mmap, so an 8GB matrix "loads" in the time it takes to map the
+// pages, and every worker process on the box shares one physical copy of
+// the data via the page cache.
+static const char MATRIX_FILE_MAGIC[8] = {'M', 'X', 'M', 'A', 'T', '0', '1', '\n'};
+
+struct MatrixFileHeader {
+    char magic[8];
+    uint64_t dtype;  // 1 = float64; the only dtype written today
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t rowStride;  // elements per payload row (== cols for now)
+};
+
+void Matrix::save(const std::string& path) const {
+    MatrixFileHeader hdr;
+    std::memcpy(hdr.magic, MATRIX_FILE_MAGIC, sizeof(hdr.magic));
+    hdr.dtype = 1;
+    hdr.rows = rows;
+    hdr.cols = cols;
+    hdr.rowStride = cols;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        throw std::invalid_argument("Cannot open file for writing: " + path);
+    }
+    bool ok = std::fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              std::fwrite(rawData(), sizeof(double), rows * cols, f) == rows * cols;
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        throw std::invalid_argument("Failed to write matrix file: " + path);
+    }
+}
 
-class Matrix {
+// Read-only view of a saved matrix, backed by a private read-only mapping of
+// the file. Nothing is copied at load time: pages fault in as they are
+// touched, and the kernel evicts and re-reads them as it pleases. The view
+// supports the read paths directly (element access, multiply, the buffer
+// protocol for np.asarray); copy() materialises a normal Matrix when a
+// mutable one is needed.
+class MappedMatrix {
 private:
-    std::vector<std::vector<double>> data;
+    void* base;
+    size_t length;
+    const double* payload;
     size_t rows, cols;
 
 public:
-    Matrix(size_t r, size_t c) : rows(r), cols(c) {
-        data.resize(rows, std::vector<double>(cols, 0.0));
+    explicit MappedMatrix(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::invalid_argument("Cannot open matrix file: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::invalid_argument("Cannot stat matrix file: " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length < sizeof(MatrixFileHeader)) {
+            ::close(fd);
+            throw std::invalid_argument("Not a matrix file (too short): " + path);
+        }
+        base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // the mapping keeps its own reference
+        if (base == MAP_FAILED) {
+            throw std::invalid_argument("Cannot map matrix file: " + path);
+        }
+
+        const MatrixFileHeader* hdr = static_cast<const MatrixFileHeader*>(base);
+        if (std::memcmp(hdr->magic, MATRIX_FILE_MAGIC, sizeof(hdr->magic)) != 0 ||
+            hdr->dtype != 1 || hdr->rowStride != hdr->cols) {
+            ::munmap(base, length);
+            throw std::invalid_argument("Not a matrix file (bad header): " + path);
+        }
+        rows = static_cast<size_t>(hdr->rows);
+        cols = static_cast<size_t>(hdr->cols);
+        if (length < sizeof(MatrixFileHeader) + rows * cols * sizeof(double)) {
+            ::munmap(base, length);
+            throw std::invalid_argument("Matrix file truncated: " + path);
+        }
+        payload = reinterpret_cast<const double*>(
+            static_cast<const char*>(base) + sizeof(MatrixFileHeader));
     }
-    
-    Matrix(const std::vector<std::vector<double>>& input) {
+
+    ~MappedMatrix() {
+        ::munmap(base, length);
+    }
+
+    // The mapping is owned, not shared
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    const double* rawData() const { return payload; }
+
+    double at(size_t i, size_t j) const { return payload[i * cols + j]; }
+
+    // Materialise a mutable in-memory copy
+    Matrix copy() const {
+        Matrix out(rows, cols);
+        std::memcpy(out.rawData(), payload, rows * cols * sizeof(double));
+        return out;
+    }
+
+    // this * other, running the blocked kernel straight off the mapped pages
+    Matrix multiply(const Matrix& other) const {
+        if (cols != other.getRows()) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        Matrix result(rows, other.getCols());
+        const double* A = payload;
+        const double* B = other.rawData();
+        double* C = result.rawData();
+        const size_t N = other.getCols();
+        if (rows * N * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+                gemmBlocked(A + r0 * cols, cols, B, N,
+                            C + r0 * N, N, r1 - r0, N, cols);
+            });
+        } else {
+            gemmBlocked(A, cols, B, N, C, N, rows, N, cols);
+        }
+        return result;
+    }
+
+    // Out-of-core multiply for operands bigger than RAM: this * b, streamed
+    // to a result file in the same format. A is processed in row panels
+    // sized to a fixed memory budget; each panel runs the blocked kernel
+    // across the pool, the finished rows are appended to the output, and
+    // the panel's mapped pages are dropped so a 200GB operand never fills
+    // the page cache. The next panel is prefetched (madvise WILLNEED)
+    // before the current one is computed, so disk reads overlap compute.
+    // Only b and one panel of output are ever resident.
+    void multiplyStream(const Matrix& b, const std::string& outPath,
+                        size_t panelRows = 0) const {
+        if (cols != b.getRows()) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        const size_t N = b.getCols();
+        if (panelRows == 0) {
+            // Budget covers one panel of faulted-in A plus one of output
+            static const size_t STREAM_PANEL_BYTES = 256u << 20;
+            panelRows = STREAM_PANEL_BYTES / ((cols + N) * sizeof(double));
+            if (panelRows == 0) {
+                panelRows = 1;
+            }
+        }
+        panelRows = std::min(panelRows, rows);
+
+        MatrixFileHeader hdr;
+        std::memcpy(hdr.magic, MATRIX_FILE_MAGIC, sizeof(hdr.magic));
+        hdr.dtype = 1;
+        hdr.rows = rows;
+        hdr.cols = N;
+        hdr.rowStride = N;
+
+        FILE* f = std::fopen(outPath.c_str(), "wb");
+        if (!f) {
+            throw std::invalid_argument("Cannot open file for writing: " + outPath);
+        }
+        bool ok = std::fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+
+        std::vector<double> panel(panelRows * N);
+        const double* B = b.rawData();
+        adviseRows(0, panelRows, MADV_WILLNEED);
+        for (size_t r0 = 0; ok && r0 < rows; r0 += panelRows) {
+            const size_t pr = std::min(panelRows, rows - r0);
+            adviseRows(r0 + pr, std::min(panelRows, rows - (r0 + pr)), MADV_WILLNEED);
+            std::fill(panel.begin(), panel.begin() + pr * N, 0.0);
+            const double* A = payload + r0 * cols;
+            double* C = panel.data();
+            if (pr * N * cols >= PARALLEL_MIN_FLOPS && pr > 1) {
+                ThreadPool::instance().parallelFor(0, pr, [&](size_t i0, size_t i1) {
+                    gemmBlocked(A + i0 * cols, cols, B, N,
+                                C + i0 * N, N, i1 - i0, N, cols);
+                });
+            } else {
+                gemmBlocked(A, cols, B, N, C, N, pr, N, cols);
+            }
+            ok = std::fwrite(panel.data(), sizeof(double), pr * N, f) == pr * N;
+            adviseRows(r0, pr, MADV_DONTNEED);
+        }
+        ok = (std::fclose(f) == 0) && ok;
+        if (!ok) {
+            throw std::invalid_argument("Failed to write matrix file: " + outPath);
+        }
+    }
+
+private:
+    // Best-effort page-cache advice for a row range of the mapped payload;
+    // the range is widened to page boundaries and failures are ignored.
+    void adviseRows(size_t firstRow, size_t rowCount, int advice) const {
+        if (rowCount == 0) {
+            return;
+        }
+        const long page = ::sysconf(_SC_PAGESIZE);
+        if (page <= 0) {
+            return;
+        }
+        const uintptr_t mask = static_cast<uintptr_t>(page) - 1;
+        uintptr_t start = reinterpret_cast<uintptr_t>(payload + firstRow * cols);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(payload + (firstRow + rowCount) * cols);
+        start &= ~mask;
+        ::madvise(reinterpret_cast<void*>(start), static_cast<size_t>(end - start), advice);
+    }
+};
+
+// --- Float32 matrices ---
+// Single-precision sibling of Matrix for workloads (graphics transforms,
+// embedding projections) that never needed double: float halves memory
+// traffic and doubles the SIMD width, which is roughly 2x on large
+// multiplies. The class keeps the hot paths -- construction, NumPy interop,
+// elementwise add/sub, transpose and the blocked multiply -- and converts
+// to Matrix for anything that needs the factorizations.
+class MatrixF {
+private:
+    std::vector<float> data;
+    size_t rows, cols;
+
+public:
+    MatrixF(size_t r, size_t c) : data(r * c, 0.0f), rows(r), cols(c) {}
+
+    MatrixF(const std::vector<std::vector<float>>& input) {
         rows = input.size();
         cols = input[0].size();
-        data = input;
+        data.reserve(rows * cols);
+        for (const auto& row : input) {
+            if (row.size() != cols) {
+                throw std::invalid_argument("All rows must have the same length");
+            }
+            data.insert(data.end(), row.begin(), row.end());
+        }
     }
-    
-    // Access elements
-    double& operator()(size_t i, size_t j) {
-        return data[i][j];
+
+    // Dtype-preserving NumPy constructor: a float32 array is copied as-is,
+    // anything else is cast straight to float32 -- never promoted to double
+    // and squeezed back down.
+    MatrixF(const py::array_t<float, py::array::c_style | py::array::forcecast>& input) {
+        py::buffer_info info = input.request();
+        if (info.ndim != 2) {
+            throw std::invalid_argument("Matrix requires a 2-dimensional array");
+        }
+        rows = static_cast<size_t>(info.shape[0]);
+        cols = static_cast<size_t>(info.shape[1]);
+        data.resize(rows * cols);
+        std::memcpy(data.data(), info.ptr, rows * cols * sizeof(float));
     }
-    
-    const double& operator()(size_t i, size_t j) const {
-        return data[i][j];
+
+    // Narrowing copy from the double-precision class
+    explicit MatrixF(const Matrix& m)
+        : data(m.getRows() * m.getCols()), rows(m.getRows()), cols(m.getCols()) {
+        const double* src = m.rawData();
+        for (size_t i = 0; i < rows * cols; ++i) {
+            data[i] = static_cast<float>(src[i]);
+        }
     }
-    
+
+    float& operator()(size_t i, size_t j) { return data[i * cols + j]; }
+    const float& operator()(size_t i, size_t j) const { return data[i * cols + j]; }
+
+    float* rawData() { return data.data(); }
+    const float* rawData() const { return data.data(); }
+
     size_t getRows() const { return rows; }
     size_t getCols() const { return cols; }
-    
-    // Get raw data for Python
-    std::vector<std::vector<double>> getData() const {
-        return data;
+
+    std::vector<std::vector<float>> getData() const {
+        std::vector<std::vector<float>> out(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            out[i].assign(data.begin() + i * cols, data.begin() + (i + 1) * cols);
+        }
+        return out;
     }
-    
-    // Matrix multiplication
-    Matrix multiply(const Matrix& other) const {
+
+    MatrixF multiply(const MatrixF& other) const {
         if (cols != other.rows) {
             throw std::invalid_argument("Matrix dimensions don't match for multiplication");
         }
-        
-        Matrix result(rows, other.cols);
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < other.cols; ++j) {
-                for (size_t k = 0; k < cols; ++k) {
-                    result(i, j) += data[i][k] * other(k, j);
-                }
-            }
+
+        MatrixF result(rows, other.cols);
+        const float* A = rawData();
+        const float* B = other.rawData();
+        float* C = result.rawData();
+        const size_t N = other.cols;
+        if (rows * N * cols >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, [&](size_t r0, size_t r1) {
+                gemmBlockedF(A + r0 * cols, cols, B, N,
+                             C + r0 * N, N, r1 - r0, N, cols);
+            });
+        } else {
+            gemmBlockedF(A, cols, B, N, C, N, rows, N, cols);
         }
         return result;
     }
-    
-    // Determinant (using cofactor expansion)
-    double determinant() const {
-        if (rows != cols) {
-            throw std::invalid_argument("Matrix must be square for determinant");
+
+    // Elementwise add/sub: single fused passes, simple enough that the
+    // compiler vectorizes them without help.
+    MatrixF add(const MatrixF& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions don't match");
         }
-        
-        if (rows == 1) return data[0][0];
-        if (rows == 2) return data[0][0] * data[1][1] - data[0][1] * data[1][0];
-        
-        double det = 0.0;
-        for (size_t j = 0; j < cols; ++j) {
-            Matrix minor = getMinor(0, j);
-            det += (j % 2 == 0 ? 1 : -1) * data[0][j] * minor.determinant();
+        MatrixF result(rows, cols);
+        for (size_t i = 0; i < rows * cols; ++i) {
+            result.data[i] = data[i] + other.data[i];
         }
-        return det;
+        return result;
     }
-    
-    // Matrix inverse (using Gauss-Jordan elimination)
-    Matrix inverse() const {
-        if (rows != cols) {
-            throw std::invalid_argument("Matrix must be square for inverse");
+
+    MatrixF subtract(const MatrixF& other) const {
+        if (rows != other.rows || cols != other.cols) {
+            throw std::invalid_argument("Matrix dimensions don't match");
         }
-        
-        double det = determinant();
-        if (std::abs(det) < 1e-10) {
-            throw std::invalid_argument("Matrix is singular (determinant = 0)");
+        MatrixF result(rows, cols);
+        for (size_t i = 0; i < rows * cols; ++i) {
+            result.data[i] = data[i] - other.data[i];
         }
-        
-        // Create augmented matrix [A|I]
-        Matrix augmented(rows, 2 * cols);
+        return result;
+    }
+
+    MatrixF transpose() const {
+        MatrixF t(cols, rows);
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < cols; ++j) {
-                augmented(i, j) = data[i][j];
-                augmented(i, j + cols) = (i == j) ? 1.0 : 0.0;
+                t.data[j * rows + i] = data[i * cols + j];
             }
         }
-        
-        // Gauss-Jordan elimination
-        for (size_t i = 0; i < rows; ++i) {
-            // Find pivot
-            double pivot = augmented(i, i);
-            if (std::abs(pivot) < 1e-10) {
-                throw std::invalid_argument("Matrix is singular");
+        return t;
+    }
+
+    // Widening copy for anything that needs the double-precision machinery
+    Matrix toDouble() const {
+        Matrix out(rows, cols);
+        double* dst = out.rawData();
+        for (size_t i = 0; i < rows * cols; ++i) {
+            dst[i] = static_cast<double>(data[i]);
+        }
+        return out;
+    }
+};
+
+// --- Batched operations ---
+// One call, one GIL round-trip and one parallel fan-out for a whole stack of
+// same-shaped matrices. Inputs are 3-d NumPy arrays laid out (batch, rows,
+// cols). Work is split across the pool one matrix at a time, and each item
+// runs its serial kernel: nesting the parallel kernels inside pool workers
+// would leave every worker waiting on sub-tasks no thread is free to run.
+typedef py::array_t<double, py::array::c_style | py::array::forcecast> BatchArray;
+
+py::array_t<double> multiplyBatch(const BatchArray& a, const BatchArray& b) {
+    py::buffer_info ai = a.request();
+    py::buffer_info bi = b.request();
+    if (ai.ndim != 3 || bi.ndim != 3) {
+        throw std::invalid_argument("multiply_batch expects 3-d arrays shaped (batch, rows, cols)");
+    }
+    if (ai.shape[0] != bi.shape[0]) {
+        throw std::invalid_argument("Batch sizes don't match");
+    }
+    if (ai.shape[2] != bi.shape[1]) {
+        throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+    }
+    const size_t batch = static_cast<size_t>(ai.shape[0]);
+    const size_t M = static_cast<size_t>(ai.shape[1]);
+    const size_t K = static_cast<size_t>(ai.shape[2]);
+    const size_t N = static_cast<size_t>(bi.shape[2]);
+
+    py::array_t<double> out({ static_cast<py::ssize_t>(batch),
+                              static_cast<py::ssize_t>(M),
+                              static_cast<py::ssize_t>(N) });
+    py::buffer_info oi = out.request();
+    const double* A = static_cast<const double*>(ai.ptr);
+    const double* B = static_cast<const double*>(bi.ptr);
+    double* C = static_cast<double*>(oi.ptr);
+    {
+        py::gil_scoped_release release;
+        std::memset(C, 0, batch * M * N * sizeof(double));
+        ThreadPool::instance().parallelFor(0, batch, [&](size_t b0, size_t b1) {
+            for (size_t idx = b0; idx < b1; ++idx) {
+                gemmBlocked(A + idx * M * K, K, B + idx * K * N, N,
+                            C + idx * M * N, N, M, N, K);
             }
-            
-            // Scale row
-            for (size_t j = 0; j < 2 * cols; ++j) {
-                augmented(i, j) /= pivot;
-            }
-            
-            // Eliminate column
-            for (size_t k = 0; k < rows; ++k) {
-                if (k != i) {
-                    double factor = augmented(k, i);
-                    for (size_t j = 0; j < 2 * cols; ++j) {
-                        augmented(k, j) -= factor * augmented(i, j);
-                    }
+        });
+    }
+    return out;
+}
+
+py::array_t<double> determinantBatch(const BatchArray& a) {
+    py::buffer_info ai = a.request();
+    if (ai.ndim != 3) {
+        throw std::invalid_argument("determinant_batch expects a 3-d array shaped (batch, n, n)");
+    }
+    if (ai.shape[1] != ai.shape[2]) {
+        throw std::invalid_argument("Matrix must be square for determinant");
+    }
+    const size_t batch = static_cast<size_t>(ai.shape[0]);
+    const size_t n = static_cast<size_t>(ai.shape[1]);
+
+    py::array_t<double> out({ static_cast<py::ssize_t>(batch) });
+    py::buffer_info oi = out.request();
+    const double* A = static_cast<const double*>(ai.ptr);
+    double* dets = static_cast<double*>(oi.ptr);
+    {
+        py::gil_scoped_release release;
+        ThreadPool::instance().parallelFor(0, batch, [&](size_t b0, size_t b1) {
+            ScratchFrame scratch;
+            double* lu = scratch.alloc<double>(n * n);
+            for (size_t idx = b0; idx < b1; ++idx) {
+                std::memcpy(lu, A + idx * n * n, n * n * sizeof(double));
+                int sign = luFactorInPlace(lu, n);
+                double det = sign;
+                for (size_t k = 0; k < n && sign != 0; ++k) {
+                    det *= lu[k * n + k];
+                }
+                dets[idx] = (sign == 0) ? 0.0 : det;
+            }
+        });
+    }
+    return out;
+}
+
+py::array_t<double> inverseBatch(const BatchArray& a) {
+    py::buffer_info ai = a.request();
+    if (ai.ndim != 3) {
+        throw std::invalid_argument("inverse_batch expects a 3-d array shaped (batch, n, n)");
+    }
+    if (ai.shape[1] != ai.shape[2]) {
+        throw std::invalid_argument("Matrix must be square for inverse");
+    }
+    const size_t batch = static_cast<size_t>(ai.shape[0]);
+    const size_t n = static_cast<size_t>(ai.shape[1]);
+
+    py::array_t<double> out({ static_cast<py::ssize_t>(batch),
+                              static_cast<py::ssize_t>(n),
+                              static_cast<py::ssize_t>(n) });
+    py::buffer_info oi = out.request();
+    const double* A = static_cast<const double*>(ai.ptr);
+    double* inv = static_cast<double*>(oi.ptr);
+    std::atomic<bool> anySingular(false);
+    {
+        py::gil_scoped_release release;
+        ThreadPool::instance().parallelFor(0, batch, [&](size_t b0, size_t b1) {
+            for (size_t idx = b0; idx < b1; ++idx) {
+                if (!gaussJordanInvert(A + idx * n * n, inv + idx * n * n, n, false)) {
+                    anySingular.store(true);
                 }
             }
+        });
+    }
+    if (anySingular.load()) {
+        throw std::invalid_argument("Batch contains a singular matrix");
+    }
+    return out;
+}
+
+// --- Sparse matrices (CSR) ---
+// Adjacency and feature matrices that are >99% zero don't fit in RAM as
+// dense storage. SparseMatrix keeps compressed sparse row form -- values
+// and column indices packed per row, plus a row-pointer array -- so memory
+// scales with the nonzeros. The sparse-dense multiply streams whole rows of
+// the dense operand at unit stride, accumulating into the matching output
+// row, and splits across the pool by sparse row.
+class SparseMatrix {
+public:
+    // Build from (row, col, value) triplets; duplicates are summed.
+    SparseMatrix(size_t r, size_t c,
+                 const std::vector<std::tuple<size_t, size_t, double>>& triplets)
+        : rows(r), cols(c) {
+        std::vector<std::tuple<size_t, size_t, double>> sorted(triplets);
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const std::tuple<size_t, size_t, double>& a,
+                     const std::tuple<size_t, size_t, double>& b) {
+            if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+            return std::get<1>(a) < std::get<1>(b);
+        });
+        rowPtr.assign(rows + 1, 0);
+        size_t lastRow = static_cast<size_t>(-1);
+        for (const auto& t : sorted) {
+            const size_t i = std::get<0>(t);
+            const size_t j = std::get<1>(t);
+            if (i >= rows || j >= cols) {
+                throw std::invalid_argument("Triplet index out of range");
+            }
+            if (!vals.empty() && i == lastRow && j == colIdx.back()) {
+                vals.back() += std::get<2>(t);
+                continue;
+            }
+            vals.push_back(std::get<2>(t));
+            colIdx.push_back(j);
+            ++rowPtr[i + 1];
+            lastRow = i;
         }
-        
-        // Extract inverse matrix
-        Matrix inv(rows, cols);
         for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < cols; ++j) {
-                inv(i, j) = augmented(i, j + cols);
+            rowPtr[i + 1] += rowPtr[i];
+        }
+    }
+
+    // Build from SciPy-style CSR buffers (data, indices, indptr).
+    SparseMatrix(size_t r, size_t c,
+                 const py::array_t<double, py::array::c_style | py::array::forcecast>& data,
+                 const py::array_t<long long, py::array::c_style | py::array::forcecast>& indices,
+                 const py::array_t<long long, py::array::c_style | py::array::forcecast>& indptr)
+        : rows(r), cols(c) {
+        py::buffer_info di = data.request();
+        py::buffer_info ii = indices.request();
+        py::buffer_info pi = indptr.request();
+        if (di.ndim != 1 || ii.ndim != 1 || pi.ndim != 1) {
+            throw std::invalid_argument("CSR buffers must be 1-dimensional");
+        }
+        if (static_cast<size_t>(pi.shape[0]) != rows + 1 || di.shape[0] != ii.shape[0]) {
+            throw std::invalid_argument("CSR buffer shapes are inconsistent");
+        }
+        const double* dv = static_cast<const double*>(di.ptr);
+        const long long* iv = static_cast<const long long*>(ii.ptr);
+        const long long* pv = static_cast<const long long*>(pi.ptr);
+        const size_t nz = static_cast<size_t>(di.shape[0]);
+        if (pv[0] != 0 || static_cast<size_t>(pv[rows]) != nz) {
+            throw std::invalid_argument("CSR indptr is inconsistent with data length");
+        }
+        rowPtr.resize(rows + 1);
+        for (size_t i = 0; i <= rows; ++i) {
+            if (pv[i] < 0 || (i > 0 && pv[i] < pv[i - 1])) {
+                throw std::invalid_argument("CSR indptr must be non-decreasing");
             }
+            rowPtr[i] = static_cast<size_t>(pv[i]);
+        }
+        vals.assign(dv, dv + nz);
+        colIdx.resize(nz);
+        for (size_t p = 0; p < nz; ++p) {
+            if (iv[p] < 0 || static_cast<size_t>(iv[p]) >= cols) {
+                throw std::invalid_argument("CSR column index out of range");
+            }
+            colIdx[p] = static_cast<size_t>(iv[p]);
         }
-        return inv;
     }
-    
-private:
-    Matrix getMinor(size_t row, size_t col) const {
-        Matrix minor(rows - 1, cols - 1);
-        size_t mi = 0, mj = 0;
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t nnz() const { return vals.size(); }
+
+    Matrix toDense() const {
+        Matrix out(rows, cols);
+        double* d = out.rawData();
         for (size_t i = 0; i < rows; ++i) {
-            if (i == row) continue;
-            mj = 0;
-            for (size_t j = 0; j < cols; ++j) {
-                if (j == col) continue;
-                minor(mi, mj) = data[i][j];
-                mj++;
+            for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+                d[i * cols + colIdx[p]] += vals[p];
             }
-            mi++;
         }
-        return minor;
+        return out;
     }
-};
 
-// Vector operations
-std::vector<double> dotProduct(const std::vector<double>& a, const std::vector<double>& b) {
-    if (a.size() != b.size()) {
-        throw std::invalid_argument("Vectors must have same size for dot product");
-    }
-    
-    double result = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        result += a[i] * b[i];
+    // Sparse * dense: each sparse row scales and accumulates whole rows of
+    // the dense operand, so every inner loop is unit-stride. Rows of the
+    // output are independent -- large products split across the pool.
+    Matrix multiply(const Matrix& other) const {
+        if (cols != other.getRows()) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        Matrix result(rows, other.getCols());
+        const size_t n = other.getCols();
+        const double* B = other.rawData();
+        double* C = result.rawData();
+        auto body = [&](size_t r0, size_t r1) {
+            for (size_t i = r0; i < r1; ++i) {
+                double* crow = C + i * n;
+                for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+                    const double v = vals[p];
+                    const double* brow = B + colIdx[p] * n;
+                    for (size_t j = 0; j < n; ++j) {
+                        crow[j] += v * brow[j];
+                    }
+                }
+            }
+        };
+        if (nnz() * n >= PARALLEL_MIN_FLOPS && rows > 1) {
+            ThreadPool::instance().parallelFor(0, rows, body);
+        } else {
+            body(0, rows);
+        }
+        return result;
     }
-    return {result};
-}
 
-std::vector<double> crossProduct(const std::vector<double>& a, const std::vector<double>& b) {
-    if (a.size() != 3 || b.size() != 3) {
-        throw std::invalid_argument("Cross product only defined for 3D vectors");
+    // Sparse * sparse with the classic per-row gather/scatter: a dense
+    // accumulator row plus a touched-column list keeps each output row
+    // O(nonzeros involved), independent of the column count.
+    SparseMatrix multiply(const SparseMatrix& other) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+        }
+        SparseMatrix out(rows, other.cols);
+        out.rowPtr.assign(rows + 1, 0);
+        std::vector<double> acc(other.cols, 0.0);
+        std::vector<char> mark(other.cols, 0);
+        std::vector<size_t> touched;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+                const size_t j = colIdx[p];
+                const double v = vals[p];
+                for (size_t q = other.rowPtr[j]; q < other.rowPtr[j + 1]; ++q) {
+                    const size_t jj = other.colIdx[q];
+                    if (!mark[jj]) {
+                        mark[jj] = 1;
+                        touched.push_back(jj);
+                    }
+                    acc[jj] += v * other.vals[q];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            for (size_t jj : touched) {
+                out.vals.push_back(acc[jj]);
+                out.colIdx.push_back(jj);
+                acc[jj] = 0.0;
+                mark[jj] = 0;
+            }
+            out.rowPtr[i + 1] = out.vals.size();
+            touched.clear();
+        }
+        return out;
     }
-    
-    return {
-        a[1] * b[2] - a[2] * b[1],
-        a[2] * b[0] - a[0] * b[2],
-        a[0] * b[1] - a[1] * b[0]
-    };
+
+private:
+    SparseMatrix(size_t r, size_t c) : rows(r), cols(c) {}
+
+    size_t rows, cols;
+    std::vector<double> vals;
+    std::vector<size_t> colIdx;
+    std::vector<size_t> rowPtr;
+};
+
+// Bind one square SmallMatrix instantiation under the given Python name.
+// The small ops are nanosecond-scale, so no GIL release: the guard would
+// cost more than the math.
+template <size_t N>
+void bindSmallMatrix(py::module_& m, const char* name) {
+    typedef SmallMatrix<N, N> SM;
+    py::class_<SM>(m, name)
+        .def(py::init<>())
+        .def(py::init<const std::vector<std::vector<double>>&>())
+        .def("__call__", [](SM& s, size_t i, size_t j) -> double& {
+            return s(i, j);
+        }, py::return_value_policy::reference)
+        .def("get_rows", &SM::getRows)
+        .def("get_cols", &SM::getCols)
+        .def("get_data", &SM::getData)
+        .def("multiply", [](const SM& a, const SM& b) { return a.multiply(b); })
+        .def("determinant", [](const SM& a) { return a.determinant(); })
+        .def("inverse", [](const SM& a) { return a.inverse(); });
 }
 
 // Python bindings
 PYBIND11_MODULE(matrix_ops, m) {
     m.doc() = "Simple matrix operations library";
     
-    py::class_<Matrix>(m, "Matrix")
+    py::class_<Matrix>(m, "Matrix", py::buffer_protocol())
         .def(py::init<size_t, size_t>())
+        // The ndarray form must be registered before the nested-list form:
+        // overloads are tried in registration order, and a float64 ndarray
+        // also satisfies the vector<vector<double>> caster, which would
+        // silently route numpy input through the per-element slow path.
+        .def(py::init<const py::array_t<double, py::array::c_style | py::array::forcecast>&>())
         .def(py::init<const std::vector<std::vector<double>>&>())
+        // Flat-buffer form: the converted vector is moved straight into the
+        // matrix, so a flat list pays one conversion and zero extra copies
+        // (the nested-list form above copies row by row).
+        .def(py::init<size_t, size_t, std::vector<double>&&>())
+        // Buffer protocol: np.asarray(m) sees the flat storage directly,
+        // no copy at all. exportData() pins the storage so later C++-side
+        // copies snapshot rather than sharing it out from under the array.
+        .def_buffer([](Matrix& m) -> py::buffer_info {
+            return py::buffer_info(
+                m.exportData(),
+                sizeof(double),
+                py::format_descriptor<double>::format(),
+                2,
+                { static_cast<py::ssize_t>(m.getRows()), static_cast<py::ssize_t>(m.getCols()) },
+                { static_cast<py::ssize_t>(m.getCols() * sizeof(double)),
+                  static_cast<py::ssize_t>(sizeof(double)) }
+            );
+        })
+        // Zero-copy NumPy view; the base handle keeps the Matrix alive for
+        // as long as the array (or anything sharing its memory) exists.
+        .def("numpy", [](py::object self) {
+            Matrix& m = self.cast<Matrix&>();
+            return py::array_t<double>(
+                { static_cast<py::ssize_t>(m.getRows()), static_cast<py::ssize_t>(m.getCols()) },
+                { static_cast<py::ssize_t>(m.getCols() * sizeof(double)),
+                  static_cast<py::ssize_t>(sizeof(double)) },
+                m.exportData(),
+                self
+            );
+        })
         .def("__call__", [](Matrix& m, size_t i, size_t j) -> double& {
             return m(i, j);
         }, py::return_value_policy::reference)
         .def("get_rows", &Matrix::getRows)
         .def("get_cols", &Matrix::getCols)
         .def("get_data", &Matrix::getData)
-        .def("multiply", &Matrix::multiply)
-        .def("determinant", &Matrix::determinant)
-        .def("inverse", &Matrix::inverse)
+        // O(1) defensive copy: storage is shared copy-on-write, so the
+        // physical duplication only happens if one side later mutates.
+        .def("copy", [](const Matrix& m) { return Matrix(m); })
+        // The heavy kernels never touch Python objects, so they drop the GIL
+        // for their whole duration: other Python threads keep running and the
+        // kernels are free to fan out across the pool.
+        // Elementwise arithmetic routes through the expression templates, so
+        // each of these is a single fused pass with exactly one result buffer.
+        .def("__add__", [](const Matrix& a, const Matrix& b) { return Matrix(a + b); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("__sub__", [](const Matrix& a, const Matrix& b) { return Matrix(a - b); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("__mul__", [](const Matrix& a, double s) { return Matrix(a * s); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("__rmul__", [](const Matrix& a, double s) { return Matrix(s * a); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("hadamard", [](const Matrix& a, const Matrix& b) { return Matrix(hadamard(a, b)); },
+             py::call_guard<py::gil_scoped_release>())
+        .def("add_scaled", [](const Matrix& a, double alpha, const Matrix& b, double beta) {
+            // alpha*A + beta*B in one fused loop, the common axpy-style update
+            return Matrix(alpha * a + beta * b);
+        }, py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<Matrix (Matrix::*)(const Matrix&) const>(&Matrix::multiply),
+             py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<Matrix (Matrix::*)(const TransposeView&) const>(&Matrix::multiply),
+             py::call_guard<py::gil_scoped_release>())
+        .def("norm", &Matrix::norm, py::call_guard<py::gil_scoped_release>())
+        .def("trace", &Matrix::trace)
+        .def("max_abs", &Matrix::maxAbs, py::call_guard<py::gil_scoped_release>())
+        .def("row_sums", &Matrix::rowSums, py::call_guard<py::gil_scoped_release>())
+        .def("col_sums", &Matrix::colSums, py::call_guard<py::gil_scoped_release>())
+        .def("transpose", &Matrix::transpose, py::call_guard<py::gil_scoped_release>())
+        // keep_alive ties the base matrix to the view
+        .def("T", &Matrix::T, py::keep_alive<0, 1>())
+        .def("block", &Matrix::block, py::keep_alive<0, 1>())
+        .def("row_view", &Matrix::rowView, py::keep_alive<0, 1>())
+        .def("col_view", &Matrix::colView, py::keep_alive<0, 1>())
+        .def("multiply_into", &Matrix::multiplyInto, py::call_guard<py::gil_scoped_release>())
+        .def("inverse_into", &Matrix::inverseInto, py::call_guard<py::gil_scoped_release>())
+        .def("lu", &Matrix::lu, py::call_guard<py::gil_scoped_release>())
+        .def("cholesky", &Matrix::cholesky, py::call_guard<py::gil_scoped_release>())
+        .def("qr", &Matrix::qr, py::call_guard<py::gil_scoped_release>())
+        .def("eigh", &Matrix::eigh, py::call_guard<py::gil_scoped_release>())
+        .def("top_k_eigen", &Matrix::topKEigen, py::call_guard<py::gil_scoped_release>())
+        .def("solve", &Matrix::solve, py::call_guard<py::gil_scoped_release>())
+        .def("lstsq", &Matrix::lstsq, py::call_guard<py::gil_scoped_release>())
+        .def("determinant", &Matrix::determinant, py::call_guard<py::gil_scoped_release>())
+        .def("inverse", &Matrix::inverse, py::call_guard<py::gil_scoped_release>())
+        // Async variants return immediately; keep_alive ties the operand
+        // matrices to the handle so the background thread never reads a
+        // freed buffer.
+        .def("multiply_async", &Matrix::multiplyAsync,
+             py::keep_alive<0, 1>(), py::keep_alive<0, 2>())
+        .def("inverse_async", &Matrix::inverseAsync, py::keep_alive<0, 1>())
+        .def("save", &Matrix::save, py::call_guard<py::gil_scoped_release>())
+        // load() maps the file instead of reading it: returns a read-only
+        // MappedMatrix view, not a Matrix -- call .copy() for a mutable one.
+        .def_static("load", [](const std::string& path) {
+            return new MappedMatrix(path);
+        }, py::call_guard<py::gil_scoped_release>())
         .def("__repr__", [](const Matrix& m) {
             std::string result = "Matrix([\n";
             auto data = m.getData();
@@ -221,6 +4256,262 @@ PYBIND11_MODULE(matrix_ops, m) {
             return result;
         });
     
+    // Fixed-size transform types: stack storage, unrolled kernels,
+    // closed-form determinant/inverse
+    bindSmallMatrix<2>(m, "Matrix2");
+    bindSmallMatrix<3>(m, "Matrix3");
+    bindSmallMatrix<4>(m, "Matrix4");
+
+    py::class_<TransposeView>(m, "TransposeView")
+        .def("get_rows", &TransposeView::getRows)
+        .def("get_cols", &TransposeView::getCols)
+        .def("eval", &TransposeView::eval, py::call_guard<py::gil_scoped_release>())
+        .def("multiply", &TransposeView::multiply, py::call_guard<py::gil_scoped_release>());
+
+    // Strided block views: reads and writes go straight through to the
+    // parent matrix; keep_alive chains the parent through nested views.
+    py::class_<MatrixView>(m, "MatrixView")
+        .def("get_rows", &MatrixView::getRows)
+        .def("get_cols", &MatrixView::getCols)
+        .def("__call__", &MatrixView::at)
+        .def("set", &MatrixView::set)
+        .def("eval", &MatrixView::eval, py::call_guard<py::gil_scoped_release>())
+        .def("assign", &MatrixView::assign, py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<Matrix (MatrixView::*)(const Matrix&) const>(&MatrixView::multiply),
+             py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<Matrix (MatrixView::*)(const MatrixView&) const>(&MatrixView::multiply),
+             py::call_guard<py::gil_scoped_release>())
+        .def("determinant", &MatrixView::determinant, py::call_guard<py::gil_scoped_release>())
+        .def("row_view", &MatrixView::rowView, py::keep_alive<0, 1>())
+        .def("col_view", &MatrixView::colView, py::keep_alive<0, 1>());
+
+    // Handle for an in-flight async operation. get() drops the GIL while it
+    // waits, so other Python threads (and other async launches) keep running.
+    py::class_<AsyncMatrixResult>(m, "AsyncResult")
+        .def("done", &AsyncMatrixResult::done)
+        .def("get", &AsyncMatrixResult::get,
+             py::return_value_policy::reference_internal,
+             py::call_guard<py::gil_scoped_release>());
+
+    py::class_<VectorView>(m, "VectorView")
+        .def("size", &VectorView::size)
+        .def("__call__", &VectorView::at)
+        .def("to_vector", &VectorView::toVector)
+        .def("dot", &VectorView::dot);
+
+    py::class_<LUDecomposition>(m, "LU")
+        .def(py::init<const Matrix&>(), py::call_guard<py::gil_scoped_release>())
+        .def("is_singular", &LUDecomposition::isSingular)
+        .def("det", &LUDecomposition::det)
+        .def("solve",
+             static_cast<std::vector<double> (LUDecomposition::*)(const std::vector<double>&) const>(
+                 &LUDecomposition::solve),
+             py::call_guard<py::gil_scoped_release>())
+        .def("solve", &LUDecomposition::solveMatrix, py::call_guard<py::gil_scoped_release>())
+        .def("inverse", &LUDecomposition::inverse, py::call_guard<py::gil_scoped_release>());
+
+    // Plan/execute API for fixed-shape pipelines: shapes are validated and
+    // output buffers allocated while the plan is built, execute() just runs
+    // the recorded kernels. result() exposes the internal output buffers
+    // without copying; reference_internal keeps the pipeline alive.
+    py::class_<Pipeline>(m, "Pipeline")
+        .def(py::init<>())
+        .def("input", &Pipeline::input)
+        .def("multiply", &Pipeline::multiply)
+        .def("add", &Pipeline::add)
+        .def("subtract", &Pipeline::subtract)
+        .def("inverse", &Pipeline::inverse)
+        .def("dot", &Pipeline::dot)
+        .def("execute", &Pipeline::execute, py::call_guard<py::gil_scoped_release>())
+        .def("result", &Pipeline::result, py::return_value_policy::reference_internal);
+
+    py::class_<CholeskyDecomposition>(m, "Cholesky")
+        .def(py::init<const Matrix&>(), py::call_guard<py::gil_scoped_release>())
+        .def("is_spd", &CholeskyDecomposition::isSpd)
+        .def("logdet", &CholeskyDecomposition::logdet)
+        .def("solve",
+             static_cast<std::vector<double> (CholeskyDecomposition::*)(const std::vector<double>&) const>(
+                 &CholeskyDecomposition::solve),
+             py::call_guard<py::gil_scoped_release>())
+        .def("solve", &CholeskyDecomposition::solveMatrix, py::call_guard<py::gil_scoped_release>())
+        .def("inverse", &CholeskyDecomposition::inverse, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<QRDecomposition>(m, "QR")
+        .def(py::init<const Matrix&>(), py::call_guard<py::gil_scoped_release>())
+        .def("is_full_rank", &QRDecomposition::isFullRank)
+        .def("q", &QRDecomposition::q, py::call_guard<py::gil_scoped_release>())
+        .def("r", &QRDecomposition::r, py::call_guard<py::gil_scoped_release>())
+        .def("lstsq",
+             static_cast<std::vector<double> (QRDecomposition::*)(const std::vector<double>&) const>(
+                 &QRDecomposition::lstsq),
+             py::call_guard<py::gil_scoped_release>())
+        .def("lstsq", &QRDecomposition::lstsqMatrix, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<SymmetricEigen>(m, "SymmetricEigen")
+        .def(py::init<const Matrix&>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const Matrix&, size_t>(), py::call_guard<py::gil_scoped_release>())
+        .def("values", &SymmetricEigen::values)
+        .def("vectors", &SymmetricEigen::vectors);
+
+    // Read-only view over a saved matrix file. The buffer is exported
+    // read-only, so np.asarray() gives a zero-copy array NumPy refuses to
+    // write through.
+    py::class_<MappedMatrix>(m, "MappedMatrix", py::buffer_protocol())
+        .def(py::init<const std::string&>(), py::call_guard<py::gil_scoped_release>())
+        .def_buffer([](MappedMatrix& m) -> py::buffer_info {
+            return py::buffer_info(
+                const_cast<double*>(m.rawData()),
+                sizeof(double),
+                py::format_descriptor<double>::format(),
+                2,
+                { static_cast<py::ssize_t>(m.getRows()), static_cast<py::ssize_t>(m.getCols()) },
+                { static_cast<py::ssize_t>(m.getCols() * sizeof(double)),
+                  static_cast<py::ssize_t>(sizeof(double)) },
+                true  // readonly
+            );
+        })
+        .def("__call__", &MappedMatrix::at)
+        .def("get_rows", &MappedMatrix::getRows)
+        .def("get_cols", &MappedMatrix::getCols)
+        .def("copy", &MappedMatrix::copy, py::call_guard<py::gil_scoped_release>())
+        .def("multiply", &MappedMatrix::multiply, py::call_guard<py::gil_scoped_release>())
+        // Out-of-core: result goes to a file, not memory; panel_rows=0
+        // picks a panel size from the memory budget
+        .def("multiply_stream", &MappedMatrix::multiplyStream,
+             py::call_guard<py::gil_scoped_release>(),
+             py::arg("b"), py::arg("path"), py::arg("panel_rows") = 0);
+
+    // Single-precision matrices: the same surface for the hot paths, float32
+    // end to end so NumPy float32 arrays round-trip without promotion.
+    py::class_<MatrixF>(m, "Matrix32", py::buffer_protocol())
+        .def(py::init<size_t, size_t>())
+        // ndarray before nested list, same ordering rationale as Matrix
+        .def(py::init<const py::array_t<float, py::array::c_style | py::array::forcecast>&>())
+        .def(py::init<const std::vector<std::vector<float>>&>())
+        .def(py::init<const Matrix&>())
+        .def_buffer([](MatrixF& m) -> py::buffer_info {
+            return py::buffer_info(
+                m.rawData(),
+                sizeof(float),
+                py::format_descriptor<float>::format(),
+                2,
+                { static_cast<py::ssize_t>(m.getRows()), static_cast<py::ssize_t>(m.getCols()) },
+                { static_cast<py::ssize_t>(m.getCols() * sizeof(float)),
+                  static_cast<py::ssize_t>(sizeof(float)) }
+            );
+        })
+        .def("numpy", [](py::object self) {
+            MatrixF& m = self.cast<MatrixF&>();
+            return py::array_t<float>(
+                { static_cast<py::ssize_t>(m.getRows()), static_cast<py::ssize_t>(m.getCols()) },
+                { static_cast<py::ssize_t>(m.getCols() * sizeof(float)),
+                  static_cast<py::ssize_t>(sizeof(float)) },
+                m.rawData(),
+                self
+            );
+        })
+        .def("__call__", [](MatrixF& m, size_t i, size_t j) -> float& {
+            return m(i, j);
+        }, py::return_value_policy::reference)
+        .def("get_rows", &MatrixF::getRows)
+        .def("get_cols", &MatrixF::getCols)
+        .def("get_data", &MatrixF::getData)
+        .def("multiply", &MatrixF::multiply, py::call_guard<py::gil_scoped_release>())
+        .def("__add__", &MatrixF::add, py::call_guard<py::gil_scoped_release>())
+        .def("__sub__", &MatrixF::subtract, py::call_guard<py::gil_scoped_release>())
+        .def("transpose", &MatrixF::transpose, py::call_guard<py::gil_scoped_release>())
+        .def("to_float64", &MatrixF::toDouble, py::call_guard<py::gil_scoped_release>());
+    // Dtype-named alias so call sites can spell the precision explicitly
+    m.attr("Matrix64") = m.attr("Matrix");
+
+    // CSR sparse matrices: memory scales with the nonzeros, multiply
+    // streams the dense operand row-wise.
+    py::class_<SparseMatrix>(m, "SparseMatrix")
+        .def(py::init<size_t, size_t,
+                      const std::vector<std::tuple<size_t, size_t, double>>&>())
+        .def(py::init<size_t, size_t,
+                      const py::array_t<double, py::array::c_style | py::array::forcecast>&,
+                      const py::array_t<long long, py::array::c_style | py::array::forcecast>&,
+                      const py::array_t<long long, py::array::c_style | py::array::forcecast>&>())
+        .def("get_rows", &SparseMatrix::getRows)
+        .def("get_cols", &SparseMatrix::getCols)
+        .def("nnz", &SparseMatrix::nnz)
+        .def("to_dense", &SparseMatrix::toDense, py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<Matrix (SparseMatrix::*)(const Matrix&) const>(&SparseMatrix::multiply),
+             py::call_guard<py::gil_scoped_release>())
+        .def("multiply",
+             static_cast<SparseMatrix (SparseMatrix::*)(const SparseMatrix&) const>(
+                 &SparseMatrix::multiply),
+             py::call_guard<py::gil_scoped_release>());
+
+    m.def("multiply_batch", &multiplyBatch,
+          "Multiply a stack of matrix pairs: (batch, m, k) x (batch, k, n) -> (batch, m, n)");
+    m.def("determinant_batch", &determinantBatch,
+          "Determinants of a stack of square matrices: (batch, n, n) -> (batch,)");
+    m.def("inverse_batch", &inverseBatch,
+          "Inverses of a stack of square matrices: (batch, n, n) -> (batch, n, n)");
+
+    // Instrumentation: per-operation counters since import (or the last
+    // reset), aggregated across threads. Set MATRIX_OPS_TRACE=<path> before
+    // import to additionally stream chrome-tracing spans.
+    m.def("perf_stats", []() {
+        auto snap = PerfCounters::snapshot();
+        py::dict out;
+        for (int op = 0; op < PerfCounters::OpCount; ++op) {
+            py::dict s;
+            s["calls"] = snap[op].calls;
+            s["ns"] = snap[op].ns;
+            s["flops"] = snap[op].flops;
+            s["bytes"] = snap[op].bytes;
+            s["allocs"] = snap[op].allocs;
+            out[PerfCounters::opName(op)] = s;
+        }
+        return out;
+    }, "Snapshot per-operation performance counters");
+    m.def("perf_reset", &PerfCounters::reset, "Zero the performance counters");
+
+    // Parallelism control. The default honors MATRIX_OPS_NUM_THREADS /
+    // OMP_NUM_THREADS; this overrides it at runtime (counting the calling
+    // thread, so 1 means fully serial).
+    m.def("set_num_threads", [](size_t n) {
+        ThreadPool::instance().resize(n);
+    }, "Resize the worker pool to n threads (including the calling thread)");
+    m.def("get_num_threads", []() {
+        return ThreadPool::instance().threadCount();
+    }, "Number of threads the kernels fan out across");
+
+    // Tuning/test knob for the Strassen tier: the defaults only engage it on
+    // giant multiplies, so lowering these is the only way to exercise the
+    // recursion at test-friendly sizes.
+    m.def("set_strassen_thresholds", [](size_t min_dim, size_t crossover) {
+        if (min_dim == 0 || crossover == 0) {
+            throw std::invalid_argument("Strassen thresholds must be positive");
+        }
+        STRASSEN_MIN_DIM = min_dim;
+        STRASSEN_CROSSOVER = crossover;
+    }, "Override the dimensions where the Strassen tier engages and bottoms out");
+
+    m.def("simd_level", []() {
+        switch (SIMD_TIER) {
+            case SimdAvx512: return "avx512";
+            case SimdAvx2:   return "avx2";
+            default:         return "scalar";
+        }
+    }, "ISA tier the kernel dispatch selected at import");
+
     m.def("dot_product", &dotProduct, "Calculate dot product of two vectors");
+    m.def("dot_product", [](const VectorView& a, const VectorView& b) {
+        return a.dot(b);
+    }, "Dot product of two strided vector views");
     m.def("cross_product", &crossProduct, "Calculate cross product of two 3D vectors");
+    // Fused multiply-accumulate: C = alpha*A*B + beta*C in place, the shape
+    // every "multiply then add bias/residual" layer wants.
+    m.def("gemm", &gemm,
+          py::call_guard<py::gil_scoped_release>(),
+          py::arg("a"), py::arg("b"), py::arg("c"),
+          py::arg("alpha") = 1.0, py::arg("beta") = 0.0,
+          "C = alpha*A*B + beta*C accumulated into c");
 }
\ No newline at end of file
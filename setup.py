@@ -10,6 +10,10 @@ try:
             include_dirs=[get_include()],
             language='c++',
             cxx_std=11,
+            # No -march=native: the hot kernels are compiled at several ISA
+            # levels via per-function target attributes and dispatched by
+            # CPUID at import, so one build serves the whole fleet.
+            extra_compile_args=['-O3'],
         ),
     ]
     
@@ -31,7 +35,7 @@ except ImportError:
             ["matrix_ops.cpp"],
             include_dirs=[pybind11.get_include()],
             language='c++',
-            extra_compile_args=['-std=c++11'],
+            extra_compile_args=['-std=c++11', '-O3'],
         ),
     ]
     
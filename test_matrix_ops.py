@@ -39,6 +39,16 @@ def test_matrix_creation():
     assert data[1][1] == 4
     print(" Matrix data access")
 
+    # Test flat-buffer construction (row-major)
+    C = matrix_ops.Matrix(2, 3, [1, 2, 3, 4, 5, 6])
+    assert C.get_data() == [[1, 2, 3], [4, 5, 6]]
+    try:
+        matrix_ops.Matrix(2, 2, [1, 2, 3])
+        assert False, "Should have raised size mismatch"
+    except Exception:
+        pass
+    print(" Flat-buffer construction")
+
 def test_matrix_multiplication():
     """Test matrix multiplication"""
     print("\n=== Testing Matrix Multiplication ===")
@@ -65,6 +75,166 @@ def test_matrix_multiplication():
     except Exception as e:
         print(" Dimension mismatch handling")
 
+def test_strassen():
+    """Test the Strassen tier against the classical kernel"""
+    print("\n=== Testing Strassen Multiply ===")
+
+    import random
+    rng = random.Random(21)
+
+    def rand_mat(r, c):
+        return matrix_ops.Matrix([[rng.uniform(-1, 1) for _ in range(c)]
+                                  for _ in range(r)])
+
+    def max_abs_diff(X, Y):
+        return max(abs(x - y)
+                   for xr, yr in zip(X.get_data(), Y.get_data())
+                   for x, y in zip(xr, yr))
+
+    def classical(A, B):
+        # Thresholds no multiply reaches: the classical kernel is the oracle
+        matrix_ops.set_strassen_thresholds(10**9, 10**9)
+        ref = A.multiply(B)
+        matrix_ops.set_strassen_thresholds(32, 16)
+        return ref
+
+    # Lowered thresholds let the recursion run at test-friendly sizes
+    matrix_ops.set_strassen_thresholds(32, 16)
+    try:
+        # Power of two: 64 -> 32 -> 16 hits the crossover cleanly
+        A = rand_mat(64, 64)
+        B = rand_mat(64, 64)
+        assert max_abs_diff(A.multiply(B), classical(A, B)) < 1e-9
+        print(" Strassen matches classical on 64x64")
+
+        # Non-power-of-two: 36 halves to 18, then 9 is odd and falls back
+        # to the classical leaf
+        A = rand_mat(36, 36)
+        B = rand_mat(36, 36)
+        assert max_abs_diff(A.multiply(B), classical(A, B)) < 1e-9
+        print(" Strassen matches classical on 36x36 (odd fallback)")
+
+        # Rectangular shapes split on all three dimensions
+        A = rand_mat(64, 48)
+        B = rand_mat(48, 32)
+        assert max_abs_diff(A.multiply(B), classical(A, B)) < 1e-9
+        print(" Strassen matches classical on 64x48 * 48x32")
+    finally:
+        matrix_ops.set_strassen_thresholds(2048, 1024)
+
+def test_into_variants():
+    """Test allocation-free multiply_into/inverse_into"""
+    print("\n=== Testing Into Variants ===")
+
+    A = matrix_ops.Matrix([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix([[5, 6], [7, 8]])
+    out = matrix_ops.Matrix(2, 2)
+
+    A.multiply_into(B, out)
+    data = out.get_data()
+    assert data[0][0] == 19
+    assert data[1][1] == 50
+    print(" multiply_into")
+
+    # Output is overwritten, not accumulated into
+    A.multiply_into(B, out)
+    assert out.get_data()[0][0] == 19
+    print(" multiply_into reuses output")
+
+    # Wrong output shape
+    try:
+        A.multiply_into(B, matrix_ops.Matrix(3, 3))
+        assert False, "Should have raised dimension error"
+    except Exception as e:
+        print(" multiply_into shape check")
+
+    inv = matrix_ops.Matrix(2, 2)
+    A.inverse_into(inv)
+    identity = A.multiply(inv)
+    data = identity.get_data()
+    assert abs(data[0][0] - 1) < 1e-10
+    assert abs(data[0][1]) < 1e-10
+    print(" inverse_into")
+
+def test_gemm():
+    """Test fused C = alpha*A*B + beta*C"""
+    print("\n=== Testing Fused GEMM ===")
+
+    A = matrix_ops.Matrix([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix([[5, 6], [7, 8]])
+
+    # Full alpha/beta form: C = 2*A*B + 3*C
+    C = matrix_ops.Matrix([[1, 1], [1, 1]])
+    matrix_ops.gemm(A, B, C, alpha=2.0, beta=3.0)
+    data = C.get_data()
+    assert data[0][0] == 2 * 19 + 3
+    assert data[0][1] == 2 * 22 + 3
+    assert data[1][0] == 2 * 43 + 3
+    assert data[1][1] == 2 * 50 + 3
+    print(" gemm accumulates alpha*A*B + beta*C")
+
+    # Defaults (alpha=1, beta=0) overwrite C like a plain multiply,
+    # ignoring whatever was there before
+    D = matrix_ops.Matrix([[9, 9], [9, 9]])
+    matrix_ops.gemm(A, B, D)
+    assert D.get_data() == A.multiply(B).get_data()
+    print(" gemm defaults match multiply")
+
+    # beta=1 is the bias/residual-add shape
+    E = A.multiply(B)
+    matrix_ops.gemm(A, B, E, beta=1.0)
+    assert E.get_data()[0][0] == 2 * 19
+    print(" gemm beta=1 accumulates in place")
+
+    # Shape and aliasing checks
+    try:
+        matrix_ops.gemm(A, B, matrix_ops.Matrix(3, 3))
+        assert False, "Should have raised dimension error"
+    except Exception:
+        print(" gemm output shape check")
+
+    try:
+        matrix_ops.gemm(A, B, A)
+        assert False, "Should have raised aliasing error"
+    except Exception:
+        print(" gemm aliasing check")
+
+def test_elementwise_arithmetic():
+    """Test fused elementwise operators"""
+    print("\n=== Testing Elementwise Arithmetic ===")
+
+    A = matrix_ops.Matrix([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix([[5, 6], [7, 8]])
+
+    C = A + B
+    assert C.get_data() == [[6, 8], [10, 12]]
+    print(" addition")
+
+    D = B - A
+    assert D.get_data() == [[4, 4], [4, 4]]
+    print(" subtraction")
+
+    E = A * 2.0
+    assert E.get_data() == [[2, 4], [6, 8]]
+    F = 3.0 * A
+    assert F.get_data() == [[3, 6], [9, 12]]
+    print(" scalar multiplication")
+
+    G = A.hadamard(B)
+    assert G.get_data() == [[5, 12], [21, 32]]
+    print(" hadamard product")
+
+    H = A.add_scaled(2.0, B, -1.0)  # 2A - B
+    assert H.get_data() == [[-3, -2], [-1, 0]]
+    print(" fused add_scaled")
+
+    # Shape mismatch
+    try:
+        A + matrix_ops.Matrix(3, 3)
+        assert False, "Should have raised dimension error"
+    except Exception as e:
+        print(" elementwise shape check")
+
 def test_determinant():
     """Test determinant calculation"""
     print("\n=== Testing Determinant ===")
@@ -93,6 +263,13 @@ def test_determinant():
     assert abs(det_D - 5) < 1e-10
     print(" 1x1 determinant")
 
+    # 12x12 triangular matrix (intractable with cofactor expansion)
+    n = 12
+    E = matrix_ops.Matrix([[2.0 if i == j else (1.0 if j > i else 0.0) for j in range(n)] for i in range(n)])
+    det_E = E.determinant()
+    assert abs(det_E - 2.0 ** n) < 1e-6
+    print(" 12x12 triangular determinant")
+
 def test_matrix_inverse():
     """Test matrix inverse calculation"""
     print("\n=== Testing Matrix Inverse ===")
@@ -132,6 +309,562 @@ def test_matrix_inverse():
             assert abs(data3[i][j] - expected) < 1e-10
     print(" 3x3 matrix inverse")
 
+def test_transpose():
+    """Test transpose and lazy transpose views"""
+    print("\n=== Testing Transpose ===")
+
+    A = matrix_ops.Matrix([[1, 2, 3], [4, 5, 6]])
+    At = A.transpose()
+    assert At.get_rows() == 3 and At.get_cols() == 2
+    assert At.get_data() == [[1, 4], [2, 5], [3, 6]]
+    print(" transpose")
+
+    # Lazy view: shape is swapped, eval materializes
+    v = A.T()
+    assert v.get_rows() == 3 and v.get_cols() == 2
+    assert v.eval().get_data() == At.get_data()
+    print(" transpose view")
+
+    # A^T * B without materializing
+    B = matrix_ops.Matrix([[1, 0], [0, 1], [1, 1]])
+    C = matrix_ops.Matrix([[1, 1], [2, 0]])
+    ref = At.multiply(C)
+    lazy = v.multiply(C)
+    assert lazy.get_data() == ref.get_data()
+    print(" view.multiply (A^T * B)")
+
+    # A * B^T without materializing (B is 2x3, so B^T is 3x2)
+    B2 = matrix_ops.Matrix([[1, 0, 1], [0, 1, 1]])
+    ref2 = A.multiply(B2.transpose())
+    lazy2 = A.multiply(B2.T())
+    assert lazy2.get_data() == ref2.get_data()
+    print(" multiply with view (A * B^T)")
+
+    # Dimension checks still apply
+    try:
+        v.multiply(matrix_ops.Matrix(5, 5))
+        assert False, "Should have raised dimension error"
+    except Exception as e:
+        print(" view dimension check")
+
+def test_block_views():
+    """Test strided submatrix and vector views"""
+    print("\n=== Testing Block Views ===")
+
+    A = matrix_ops.Matrix([[1, 2, 3, 4],
+                           [5, 6, 7, 8],
+                           [9, 10, 11, 12],
+                           [13, 14, 15, 16]])
+
+    # 2x2 window at (1, 1): no copy, elements read through to A
+    v = A.block(1, 1, 2, 2)
+    assert v.get_rows() == 2 and v.get_cols() == 2
+    assert v(0, 0) == 6 and v(1, 1) == 11
+    print(" block view element access")
+
+    # eval materializes a contiguous copy
+    assert v.eval().get_data() == [[6, 7], [10, 11]]
+    print(" block view eval")
+
+    # multiply runs off the strided storage
+    B = matrix_ops.Matrix([[1, 0], [1, 1]])
+    ref = v.eval().multiply(B)
+    assert v.multiply(B).get_data() == ref.get_data()
+    print(" block view multiply")
+
+    # view * view
+    w = A.block(1, 1, 2, 2)
+    assert v.multiply(w).get_data() == v.eval().multiply(w.eval()).get_data()
+    print(" view * view multiply")
+
+    # determinant of a square block
+    assert abs(v.determinant() - v.eval().determinant()) < 1e-10
+    print(" block view determinant")
+
+    # writes land in the parent
+    v.set(0, 0, 99)
+    assert A(1, 1) == 99
+    v.assign(matrix_ops.Matrix([[6, 7], [10, 11]]))
+    assert A(1, 1) == 6
+    print(" block view writes through")
+
+    # row/column vector views with dot_product
+    r = A.row_view(0)
+    c = A.col_view(0)
+    assert r.size() == 4 and c.size() == 4
+    assert r.to_vector() == [1, 2, 3, 4]
+    assert c.to_vector() == [1, 5, 9, 13]
+    expected = sum(x * y for x, y in zip(r.to_vector(), c.to_vector()))
+    assert abs(matrix_ops.dot_product(r, c) - expected) < 1e-10
+    assert abs(r.dot(c) - expected) < 1e-10
+    print(" row/col vector views and dot_product")
+
+    # out-of-range block rejected
+    try:
+        A.block(3, 3, 2, 2)
+        assert False, "Should have raised range error"
+    except Exception:
+        print(" block bounds check")
+
+def test_reductions():
+    """Test norm/trace/row_sums/col_sums/max_abs reductions"""
+    print("\n=== Testing Reductions ===")
+
+    A = matrix_ops.Matrix([[1, -2, 3], [4, 5, -6]])
+
+    expected_norm = math.sqrt(sum(v * v for row in A.get_data() for v in row))
+    assert abs(A.norm() - expected_norm) < 1e-10
+    print(" frobenius norm")
+
+    B = matrix_ops.Matrix([[2, 1], [1, 3]])
+    assert abs(B.trace() - 5) < 1e-10
+    try:
+        A.trace()
+        assert False, "Should have raised square error"
+    except Exception:
+        pass
+    print(" trace")
+
+    assert A.max_abs() == 6
+    print(" max_abs")
+
+    assert A.row_sums() == [2, 3]
+    assert A.col_sums() == [5, 3, -3]
+    print(" row/col sums")
+
+    # Large enough to take the parallel path
+    n = 600
+    C = matrix_ops.Matrix([[1.0] * n for _ in range(n)])
+    assert abs(C.norm() - n) < 1e-6
+    assert C.max_abs() == 1.0
+    assert C.row_sums()[0] == n
+    assert C.col_sums()[n - 1] == n
+    print(" parallel reductions")
+
+def test_cholesky():
+    """Test the Cholesky factorization handle for SPD matrices"""
+    print("\n=== Testing Cholesky ===")
+
+    A = matrix_ops.Matrix([[4, 2, 0], [2, 5, 1], [0, 1, 3]])
+    ch = A.cholesky()
+    assert ch.is_spd()
+    print(" SPD factorization")
+
+    # logdet agrees with log(determinant)
+    assert abs(ch.logdet() - math.log(A.determinant())) < 1e-10
+    print(" logdet")
+
+    # Solve against a vector
+    b = [2, 1, 3]
+    x = ch.solve(b)
+    for i, row in enumerate(A.get_data()):
+        assert abs(sum(a * v for a, v in zip(row, x)) - b[i]) < 1e-10
+    print(" vector solve")
+
+    # Block solve and inverse match LU
+    B = matrix_ops.Matrix([[1, 0], [0, 1], [1, 1]])
+    X = ch.solve(B)
+    X_ref = A.lu().solve(B)
+    for r, rr in zip(X.get_data(), X_ref.get_data()):
+        for v, vr in zip(r, rr):
+            assert abs(v - vr) < 1e-10
+    identity = A.multiply(ch.inverse())
+    for i in range(3):
+        for j in range(3):
+            expected = 1.0 if i == j else 0.0
+            assert abs(identity.get_data()[i][j] - expected) < 1e-10
+    print(" block solve and inverse")
+
+    # Indefinite matrix is rejected on use
+    bad = matrix_ops.Matrix([[1, 2], [2, 1]]).cholesky()
+    assert not bad.is_spd()
+    try:
+        bad.solve([1, 1])
+        assert False, "Should have raised non-SPD error"
+    except Exception:
+        print(" non-SPD handling")
+
+def test_qr_lstsq():
+    """Test QR factorization and least squares"""
+    print("\n=== Testing QR / Least Squares ===")
+
+    # Tall design matrix for fitting y = c0 + c1*x at x = 0..3
+    A = matrix_ops.Matrix([[1, 0], [1, 1], [1, 2], [1, 3]])
+    qr = A.qr()
+    assert qr.is_full_rank()
+
+    # Q R reproduces A and Q has orthonormal columns
+    Q = qr.q()
+    R = qr.r()
+    QR = Q.multiply(R)
+    for i in range(4):
+        for j in range(2):
+            assert abs(QR(i, j) - A(i, j)) < 1e-10
+    QtQ = Q.T().multiply(Q)
+    for i in range(2):
+        for j in range(2):
+            expected = 1.0 if i == j else 0.0
+            assert abs(QtQ(i, j) - expected) < 1e-10
+    print(" Q R = A with orthonormal Q")
+
+    # Consistent system recovered exactly
+    x = A.lstsq([1, 3, 5, 7])
+    assert abs(x[0] - 1) < 1e-10
+    assert abs(x[1] - 2) < 1e-10
+    # Inconsistent system: matches the normal-equations solution
+    x = qr.lstsq([1, 2, 2, 4])
+    assert abs(x[0] - 0.9) < 1e-10
+    assert abs(x[1] - 0.9) < 1e-10
+    print(" least-squares fit")
+
+    # Block right-hand sides solve both columns at once
+    B = matrix_ops.Matrix([[1, 1], [3, 2], [5, 2], [7, 4]])
+    X = qr.lstsq(B)
+    assert abs(X(0, 0) - 1) < 1e-10 and abs(X(1, 0) - 2) < 1e-10
+    assert abs(X(0, 1) - 0.9) < 1e-10 and abs(X(1, 1) - 0.9) < 1e-10
+    print(" block least squares")
+
+    # Rank-deficient and wide matrices are rejected
+    D = matrix_ops.Matrix([[1, 1], [1, 1], [1, 1]])
+    assert not D.qr().is_full_rank()
+    try:
+        D.qr().lstsq([1, 1, 1])
+        assert False, "Should have raised rank-deficient error"
+    except Exception:
+        pass
+    try:
+        matrix_ops.Matrix([[1, 2, 3], [4, 5, 6]]).qr()
+        assert False, "Should have raised shape error"
+    except Exception:
+        pass
+    print(" rank and shape checks")
+
+def test_eigen():
+    """Test the symmetric eigensolver"""
+    print("\n=== Testing Symmetric Eigensolver ===")
+
+    # Known spectrum: [[2,1],[1,2]] has eigenvalues 3 and 1
+    E = matrix_ops.Matrix([[2, 1], [1, 2]]).eigh()
+    w = E.values()
+    assert abs(w[0] - 3) < 1e-10
+    assert abs(w[1] - 1) < 1e-10
+    print(" known 2x2 spectrum")
+
+    # Reconstruction: A = V diag(w) V^T, with orthonormal V
+    A = matrix_ops.Matrix([[4, 1, 0], [1, 3, 1], [0, 1, 2]])
+    E = A.eigh()
+    w = E.values()
+    V = E.vectors()
+    assert w[0] >= w[1] >= w[2]
+    for i in range(3):
+        for j in range(3):
+            recon = sum(V(i, k) * w[k] * V(j, k) for k in range(3))
+            assert abs(recon - A(i, j)) < 1e-8
+    VtV = V.T().multiply(V)
+    for i in range(3):
+        for j in range(3):
+            expected = 1.0 if i == j else 0.0
+            assert abs(VtV(i, j) - expected) < 1e-8
+    print(" reconstruction and orthonormal vectors")
+
+    # Top-k fast path picks the leading pairs of a known diagonal
+    D = matrix_ops.Matrix([[5, 0, 0, 0], [0, 4, 0, 0],
+                           [0, 0, 1, 0], [0, 0, 0, 0.5]])
+    E = D.top_k_eigen(2)
+    w = E.values()
+    V = E.vectors()
+    assert abs(w[0] - 5) < 1e-6
+    assert abs(w[1] - 4) < 1e-6
+    # Residual check: D v = w v for each returned pair
+    for j in range(2):
+        for i in range(4):
+            Dv = sum(D(i, k) * V(k, j) for k in range(4))
+            assert abs(Dv - w[j] * V(i, j)) < 1e-6
+    print(" top-k subspace iteration")
+
+    try:
+        matrix_ops.Matrix([[1, 2, 3], [4, 5, 6]]).eigh()
+        assert False, "Should have raised non-square error"
+    except Exception:
+        pass
+    try:
+        D.top_k_eigen(5)
+        assert False, "Should have raised k out of range"
+    except Exception:
+        pass
+    print(" shape and range checks")
+
+def test_pipeline():
+    """Test the plan/execute API for fixed-shape pipelines"""
+    print("\n=== Testing Pipeline ===")
+
+    p = matrix_ops.Pipeline()
+    a = p.input(2, 2)
+    b = p.input(2, 2)
+    v = p.input(1, 3)
+    w = p.input(3, 1)
+
+    prod = p.multiply(a, b)
+    inv = p.inverse(prod)
+    s = p.add(prod, prod)
+    d = p.dot(v, w)
+
+    A = matrix_ops.Matrix([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix([[2, 0], [1, 2]])
+    V = matrix_ops.Matrix([[1, 2, 3]])
+    W = matrix_ops.Matrix([[4], [5], [6]])
+    p.execute([A, B, V, W])
+
+    ref = A.multiply(B)
+    assert p.result(prod).get_data() == ref.get_data()
+    assert p.result(s).get_data() == (ref + ref).get_data()
+    assert abs(p.result(d)(0, 0) - 32) < 1e-10
+    identity = ref.multiply(p.result(inv))
+    assert abs(identity(0, 0) - 1) < 1e-10 and abs(identity(0, 1)) < 1e-10
+    print(" planned multiply/inverse/add/dot")
+
+    # Re-execution reuses the same buffers with fresh inputs
+    p.execute([B, A, V, W])
+    assert p.result(prod).get_data() == B.multiply(A).get_data()
+    print(" repeated execute")
+
+    # Shape mismatches are caught when the plan is built...
+    try:
+        p2 = matrix_ops.Pipeline()
+        x = p2.input(2, 3)
+        p2.multiply(x, x)
+        assert False, "Should have raised dimension error"
+    except Exception:
+        print(" build-time shape check")
+
+    # ...and wrong execute-time inputs are rejected
+    try:
+        p.execute([A, B, V, matrix_ops.Matrix(2, 2)])
+        assert False, "Should have raised shape error"
+    except Exception:
+        print(" execute-time input check")
+
+def test_small_matrices():
+    """Test fixed-size Matrix2/Matrix3/Matrix4"""
+    print("\n=== Testing Small Matrices ===")
+
+    A = matrix_ops.Matrix3([[2, 1, 0], [1, 2, 1], [0, 1, 2]])
+    B = matrix_ops.Matrix3([[1, 0, 0], [0, 1, 0], [0, 0, 1]])
+
+    C = A.multiply(B)
+    assert C.get_data() == A.get_data()
+    print(" Matrix3 multiply")
+
+    assert abs(A.determinant() - 4) < 1e-10
+    print(" Matrix3 determinant")
+
+    A_inv = A.inverse()
+    ident = A.multiply(A_inv).get_data()
+    for i in range(3):
+        for j in range(3):
+            expected = 1.0 if i == j else 0.0
+            assert abs(ident[i][j] - expected) < 1e-10
+    print(" Matrix3 inverse")
+
+    # Matrix2 closed forms
+    M2 = matrix_ops.Matrix2([[1, 2], [3, 4]])
+    assert abs(M2.determinant() - (-2)) < 1e-10
+    ident2 = M2.multiply(M2.inverse()).get_data()
+    assert abs(ident2[0][0] - 1) < 1e-10 and abs(ident2[0][1]) < 1e-10
+    print(" Matrix2 determinant/inverse")
+
+    # Matrix4 against the dynamic path
+    rows4 = [[4, 1, 0, 0], [1, 4, 1, 0], [0, 1, 4, 1], [0, 0, 1, 4]]
+    M4 = matrix_ops.Matrix4(rows4)
+    D4 = matrix_ops.Matrix(rows4)
+    assert abs(M4.determinant() - D4.determinant()) < 1e-8
+    inv_small = M4.inverse().get_data()
+    inv_dyn = D4.inverse().get_data()
+    for i in range(4):
+        for j in range(4):
+            assert abs(inv_small[i][j] - inv_dyn[i][j]) < 1e-10
+    print(" Matrix4 matches dynamic Matrix")
+
+    # Singular small matrix
+    try:
+        matrix_ops.Matrix2([[1, 2], [2, 4]]).inverse()
+        assert False, "Should have raised singular matrix error"
+    except Exception as e:
+        print(" Matrix2 singular handling")
+
+    # Wrong input shape
+    try:
+        matrix_ops.Matrix3([[1, 2], [3, 4]])
+        assert False, "Should have raised shape error"
+    except Exception as e:
+        print(" Small matrix shape check")
+
+def test_float32():
+    """Test the single-precision Matrix32 class"""
+    print("\n=== Testing Float32 Matrices ===")
+
+    A = matrix_ops.Matrix32([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix32([[5, 6], [7, 8]])
+    C = A.multiply(B)
+    data = C.get_data()
+    assert data[0][0] == 19
+    assert data[0][1] == 22
+    assert data[1][0] == 43
+    assert data[1][1] == 50
+    print(" Matrix32 multiplication")
+
+    S = A + B
+    D = A - B
+    assert S.get_data()[0][0] == 6
+    assert D.get_data()[0][0] == -4
+    print(" Matrix32 add/subtract")
+
+    T = A.transpose()
+    assert T.get_rows() == 2
+    assert T.get_data()[0][1] == 3
+    print(" Matrix32 transpose")
+
+    # Round trip through double precision
+    A64 = A.to_float64()
+    assert isinstance(A64, matrix_ops.Matrix)
+    back = matrix_ops.Matrix32(A64)
+    assert back.get_data() == A.get_data()
+    print(" Matrix32 <-> Matrix conversion")
+
+    # Matrix64 is an alias for the double-precision class
+    assert matrix_ops.Matrix64 is matrix_ops.Matrix
+    print(" Matrix64 alias")
+
+    try:
+        import numpy as np
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        M = matrix_ops.Matrix32(x)
+        assert M.get_data()[1][2] == 5
+        # The view stays float32: no silent promotion to double
+        v = M.numpy()
+        assert v.dtype == np.float32
+        assert np.asarray(M).dtype == np.float32
+        print(" Matrix32 numpy dtype preserved")
+    except ImportError:
+        print(" (numpy not installed, skipping float32 dtype tests)")
+
+def test_save_load():
+    """Test the persisted matrix format and memory-mapped loading"""
+    print("\n=== Testing Save / Load ===")
+
+    import os
+    import tempfile
+
+    A = matrix_ops.Matrix([[1, 2, 3], [4, 5, 6]])
+    path = os.path.join(tempfile.mkdtemp(), "a.mxmat")
+    A.save(path)
+
+    V = matrix_ops.Matrix.load(path)
+    assert V.get_rows() == 2
+    assert V.get_cols() == 3
+    assert V(1, 2) == 6
+    print(" Mapped load and element access")
+
+    # Materialized copy behaves like a normal Matrix
+    B = V.copy()
+    assert B.get_data() == A.get_data()
+    print(" Mapped copy")
+
+    # Multiply straight off the mapped view
+    C = matrix_ops.Matrix([[1, 0], [0, 1], [1, 1]])
+    ref = A.multiply(C)
+    out = V.multiply(C)
+    assert out.get_data() == ref.get_data()
+    print(" Mapped multiply")
+
+    # Streamed out-of-core multiply produces the same file a save() of the
+    # in-memory product would; panel_rows=1 forces the panel loop
+    big = matrix_ops.Matrix([[(i * 5 + j) % 7 for j in range(8)]
+                             for i in range(10)])
+    right = matrix_ops.Matrix([[(i + 2 * j) % 5 for j in range(4)]
+                               for i in range(8)])
+    big_path = path + ".big"
+    out_path = path + ".out"
+    big.save(big_path)
+    BV = matrix_ops.Matrix.load(big_path)
+    BV.multiply_stream(right, out_path, panel_rows=1)
+    streamed = matrix_ops.Matrix.load(out_path)
+    assert streamed.copy().get_data() == big.multiply(right).get_data()
+    BV.multiply_stream(right, out_path)  # default panel sizing
+    streamed = matrix_ops.Matrix.load(out_path)
+    assert streamed.copy().get_data() == big.multiply(right).get_data()
+    print(" Streamed multiply")
+
+    # Corrupt header is rejected
+    bad = path + ".bad"
+    with open(bad, "wb") as f:
+        f.write(b"not a matrix file at all")
+    try:
+        matrix_ops.Matrix.load(bad)
+        assert False, "Should have rejected a bad header"
+    except Exception:
+        print(" Bad header rejected")
+
+    os.remove(path)
+    os.remove(bad)
+    os.remove(big_path)
+    os.remove(out_path)
+
+def test_lu_solve():
+    """Test the reusable LU factorization handle"""
+    print("\n=== Testing LU / Solve ===")
+
+    A = matrix_ops.Matrix([[2, 1, 0], [1, 2, 1], [0, 1, 2]])
+    lu = A.lu()
+
+    assert not lu.is_singular()
+    assert abs(lu.det() - 4) < 1e-10
+    print(" lu det")
+
+    # Solve against a vector, check A x == b
+    b = [1.0, 2.0, 3.0]
+    x = lu.solve(b)
+    for i, row in enumerate(A.get_data()):
+        assert abs(sum(row[j] * x[j] for j in range(3)) - b[i]) < 1e-10
+    print(" lu solve (vector)")
+
+    # One factorization, several right-hand sides
+    x2 = lu.solve([1.0, 0.0, 0.0])
+    assert abs(sum(A.get_data()[0][j] * x2[j] for j in range(3)) - 1.0) < 1e-10
+    print(" lu solve reuse")
+
+    # Solve against a matrix of right-hand sides
+    B = matrix_ops.Matrix([[1, 0], [0, 1], [0, 0]])
+    X = lu.solve(B)
+    AX = A.multiply(X)
+    for i in range(3):
+        for j in range(2):
+            assert abs(AX.get_data()[i][j] - B.get_data()[i][j]) < 1e-10
+    print(" lu solve (matrix)")
+
+    # lu.inverse agrees with Matrix.inverse
+    inv_lu = lu.inverse().get_data()
+    inv_gj = A.inverse().get_data()
+    for i in range(3):
+        for j in range(3):
+            assert abs(inv_lu[i][j] - inv_gj[i][j]) < 1e-10
+    print(" lu inverse")
+
+    # Matrix.solve convenience
+    x3 = A.solve(b)
+    assert all(abs(x3[i] - x[i]) < 1e-12 for i in range(3))
+    print(" Matrix.solve convenience")
+
+    # Singular matrix
+    S = matrix_ops.Matrix([[1, 2], [2, 4]]).lu()
+    assert S.is_singular()
+    assert S.det() == 0.0
+    try:
+        S.solve([1.0, 1.0])
+        assert False, "Should have raised singular matrix error"
+    except Exception as e:
+        print(" lu singular handling")
+
 def test_dot_product():
     """Test vector dot product"""
     print("\n=== Testing Dot Product ===")
@@ -191,6 +924,287 @@ def test_cross_product():
     except Exception as e:
         print(" Cross product dimension handling")
 
+def test_sparse():
+    """Test CSR sparse matrices and sparse-dense multiply"""
+    print("\n=== Testing Sparse Matrices ===")
+
+    # 3x4 with five nonzeros, one duplicate entry summed
+    trips = [(0, 1, 2.0), (1, 0, 1.0), (1, 3, 4.0), (2, 2, 3.0), (0, 1, 1.0)]
+    S = matrix_ops.SparseMatrix(3, 4, trips)
+    assert S.get_rows() == 3 and S.get_cols() == 4
+    assert S.nnz() == 4
+    print(" triplet construction")
+
+    dense = S.to_dense()
+    assert dense.get_data() == [[0, 3, 0, 0], [1, 0, 0, 4], [0, 0, 3, 0]]
+    print(" to_dense")
+
+    # Sparse * dense matches dense * dense
+    B = matrix_ops.Matrix([[1, 2], [3, 4], [5, 6], [7, 8]])
+    ref = dense.multiply(B)
+    assert S.multiply(B).get_data() == ref.get_data()
+    print(" sparse-dense multiply")
+
+    # Sparse * sparse matches the dense product
+    T = matrix_ops.SparseMatrix(4, 2, [(0, 0, 1.0), (1, 1, 2.0), (3, 0, 5.0)])
+    prod = S.multiply(T)
+    assert prod.to_dense().get_data() == dense.multiply(T.to_dense()).get_data()
+    print(" sparse-sparse multiply")
+
+    # Dimension mismatch
+    try:
+        S.multiply(matrix_ops.Matrix(2, 2))
+        assert False, "Should have raised dimension error"
+    except Exception:
+        print(" sparse dimension check")
+
+    try:
+        import numpy as np
+        data = np.array([3.0, 1.0, 4.0, 3.0])
+        indices = np.array([1, 0, 3, 2])
+        indptr = np.array([0, 1, 3, 4])
+        S2 = matrix_ops.SparseMatrix(3, 4, data, indices, indptr)
+        assert S2.to_dense().get_data() == dense.get_data()
+        print(" scipy-style CSR buffers")
+    except ImportError:
+        print(" (numpy not installed, skipping CSR buffer test)")
+
+def test_numpy_interop():
+    """Test zero-copy NumPy interop"""
+    print("\n=== Testing NumPy Interop ===")
+
+    try:
+        import numpy as np
+    except ImportError:
+        print(" NumPy not installed, skipping interop tests")
+        return
+
+    # Construct from a NumPy array
+    a = np.array([[1.0, 2.0], [3.0, 4.0]])
+    A = matrix_ops.Matrix(a)
+    assert A.get_rows() == 2
+    assert A.get_cols() == 2
+    assert A.get_data()[1][0] == 3.0
+    print(" Matrix creation from NumPy array")
+
+    # Buffer protocol: no-copy view via np.asarray
+    view = np.asarray(A)
+    assert view.shape == (2, 2)
+    view[0, 0] = 42.0
+    assert A.get_data()[0][0] == 42.0
+    print(" Buffer protocol view shares storage")
+
+    # numpy() view method
+    v2 = A.numpy()
+    assert v2[0, 0] == 42.0
+    v2[1, 1] = -1.0
+    assert A.get_data()[1][1] == -1.0
+    print(" numpy() view shares storage")
+
+def test_copy_on_write():
+    """Test copy-on-write sharing between Matrix copies"""
+    print("\n=== Testing Copy-on-Write ===")
+
+    A = matrix_ops.Matrix([[1.0, 2.0], [3.0, 4.0]])
+    B = A.copy()
+    assert B.get_data() == A.get_data()
+    print(" copy() matches the original")
+
+    # Writing through a view on the copy must not leak into the original
+    B.block(0, 0, 2, 2).set(0, 0, 99.0)
+    assert B.get_data()[0][0] == 99.0
+    assert A.get_data()[0][0] == 1.0
+    print(" Mutating the copy leaves the original untouched")
+
+    # Mutating the original after handing out copies
+    C = A.copy()
+    A.block(0, 0, 2, 2).set(1, 1, -7.0)
+    assert A.get_data()[1][1] == -7.0
+    assert C.get_data()[1][1] == 4.0
+    print(" Mutating the original leaves earlier copies untouched")
+
+    try:
+        import numpy as np
+    except ImportError:
+        print(" NumPy not installed, skipping exported-buffer tests")
+        return
+
+    # A matrix with a live numpy view must keep tracking it: copies taken
+    # afterwards snapshot instead of sharing, and later writes stay visible
+    # through the view.
+    D = matrix_ops.Matrix([[5.0, 6.0], [7.0, 8.0]])
+    view = D.numpy()
+    E = D.copy()
+    D.block(0, 0, 2, 2).set(0, 1, 60.0)
+    assert view[0, 1] == 60.0
+    assert E.get_data()[0][1] == 6.0
+    print(" numpy() view tracks its matrix across copies")
+
+def test_batched_ops():
+    """Test batched multiply/determinant/inverse"""
+    print("\n=== Testing Batched Operations ===")
+
+    try:
+        import numpy as np
+    except ImportError:
+        print(" NumPy not installed, skipping batched tests")
+        return
+
+    a = np.array([[[1.0, 2.0], [3.0, 4.0]],
+                  [[2.0, 0.0], [0.0, 2.0]]])
+    b = np.array([[[5.0, 6.0], [7.0, 8.0]],
+                  [[1.0, 1.0], [1.0, 1.0]]])
+
+    c = matrix_ops.multiply_batch(a, b)
+    assert c.shape == (2, 2, 2)
+    assert c[0, 0, 0] == 19 and c[0, 1, 1] == 50
+    assert c[1, 0, 0] == 2 and c[1, 1, 1] == 2
+    print(" multiply_batch")
+
+    dets = matrix_ops.determinant_batch(a)
+    assert abs(dets[0] - (-2.0)) < 1e-10
+    assert abs(dets[1] - 4.0) < 1e-10
+    print(" determinant_batch")
+
+    invs = matrix_ops.inverse_batch(a)
+    for i in range(2):
+        ident = a[i].dot(invs[i])
+        assert abs(ident[0, 0] - 1) < 1e-10 and abs(ident[0, 1]) < 1e-10
+    print(" inverse_batch")
+
+    # Singular member of the batch
+    try:
+        matrix_ops.inverse_batch(np.array([[[1.0, 2.0], [2.0, 4.0]]]))
+        assert False, "Should have raised singular matrix error"
+    except Exception as e:
+        print(" inverse_batch singular handling")
+
+def test_perf_counters():
+    """Test the per-operation performance counters"""
+    print("\n=== Testing Perf Counters ===")
+
+    matrix_ops.perf_reset()
+    A = matrix_ops.Matrix([[2, 1], [1, 3]])
+    A.multiply(A)
+    A.inverse()
+    # 1x1/2x2 determinants take the closed-form early-out; 3x3 hits the
+    # instrumented LU path
+    matrix_ops.Matrix([[2, 1, 0], [1, 2, 1], [0, 1, 2]]).determinant()
+
+    stats = matrix_ops.perf_stats()
+    assert set(stats.keys()) == {"multiply", "inverse", "determinant"}
+    assert stats["multiply"]["calls"] == 1
+    assert stats["multiply"]["flops"] == 2 * 2 * 2 * 2
+    assert stats["multiply"]["allocs"] == 1
+    assert stats["inverse"]["calls"] == 1
+    assert stats["determinant"]["calls"] == 1
+    assert stats["multiply"]["ns"] > 0
+    print(" per-op counters")
+
+    # multiply_into is counted but doesn't allocate
+    out = matrix_ops.Matrix(2, 2)
+    A.multiply_into(A, out)
+    stats = matrix_ops.perf_stats()
+    assert stats["multiply"]["calls"] == 2
+    assert stats["multiply"]["allocs"] == 1
+    print(" allocation attribution")
+
+    matrix_ops.perf_reset()
+    assert matrix_ops.perf_stats()["multiply"]["calls"] == 0
+    print(" reset")
+
+def test_simd_dispatch():
+    """Test the runtime ISA dispatch"""
+    print("\n=== Testing SIMD Dispatch ===")
+
+    level = matrix_ops.simd_level()
+    assert level in ("scalar", "avx2", "avx512")
+    print(f" dispatch selected {level}")
+
+    # Sizes straddling the vector widths exercise main loops and tails of
+    # whichever tier was selected
+    for n in (1, 7, 8, 15, 16, 31, 33):
+        a = [float(i % 9 - 4) for i in range(n)]
+        b = [float((2 * i) % 7 - 3) for i in range(n)]
+        expected = sum(x * y for x, y in zip(a, b))
+        assert abs(matrix_ops.dot_product(a, b)[0] - expected) < 1e-9
+    print(" dot kernel tails")
+
+def test_thread_controls():
+    """Test the parallelism control API"""
+    print("\n=== Testing Thread Controls ===")
+
+    default = matrix_ops.get_num_threads()
+    assert default >= 1
+    print(f" default pool size {default}")
+
+    # Results are identical whatever the pool size; 64x64 is past the
+    # parallel threshold so the serial and fanned-out paths both run
+    A = matrix_ops.Matrix([[((i * 13 + j * 7) % 11) - 5 for j in range(64)]
+                           for i in range(64)])
+    expected = A.multiply(A).get_data()
+    for threads in (1, 2, default):
+        matrix_ops.set_num_threads(threads)
+        assert matrix_ops.get_num_threads() == threads
+        assert A.multiply(A).get_data() == expected
+    print(" resize keeps results identical")
+
+    # 0 clamps to fully serial
+    matrix_ops.set_num_threads(0)
+    assert matrix_ops.get_num_threads() == 1
+    matrix_ops.set_num_threads(default)
+    print(" clamping and restore")
+
+def test_async():
+    """Test the async execution API"""
+    print("\n=== Testing Async Execution ===")
+
+    A = matrix_ops.Matrix([[1, 2], [3, 4]])
+    B = matrix_ops.Matrix([[5, 6], [7, 8]])
+    C = matrix_ops.Matrix([[2, 0], [0, 2]])
+
+    # Launch independent multiplies, then collect; results must match the
+    # synchronous versions
+    f1 = A.multiply_async(B)
+    f2 = A.multiply_async(C)
+    f3 = B.multiply_async(C)
+    assert f1.get().get_data() == A.multiply(B).get_data()
+    assert f2.get().get_data() == A.multiply(C).get_data()
+    assert f3.get().get_data() == B.multiply(C).get_data()
+    print(" overlapped multiplies")
+
+    # get() is repeatable and done() is true afterwards
+    f = A.multiply_async(B)
+    first = f.get().get_data()
+    assert f.get().get_data() == first
+    assert f.done()
+    print(" repeatable get")
+
+    inv = A.inverse_async().get()
+    assert inv.get_data() == A.inverse().get_data()
+    print(" async inverse")
+
+    # Shape mismatches raise at launch, kernel errors at get()
+    try:
+        A.multiply_async(matrix_ops.Matrix(3, 3))
+        assert False, "Should have raised dimension error"
+    except Exception:
+        print(" launch-time shape check")
+    f = matrix_ops.Matrix([[1, 2], [2, 4]]).inverse_async()
+    try:
+        f.get()
+        assert False, "Should have raised singular error"
+    except Exception:
+        print(" kernel error surfaces from get()")
+    # The handle stays usable after a failure: done() keeps answering and
+    # repeated get() calls raise the same error
+    assert f.done()
+    try:
+        f.get()
+        assert False, "Should have raised singular error again"
+    except Exception:
+        print(" failed handle stays usable")
+
 def test_edge_cases():
     """Test edge cases and error conditions"""
     print("\n=== Testing Edge Cases ===")
@@ -225,10 +1239,33 @@ def run_all_tests():
     try:
         test_matrix_creation()
         test_matrix_multiplication()
+        test_strassen()
+        test_into_variants()
+        test_gemm()
+        test_elementwise_arithmetic()
+        test_transpose()
+        test_block_views()
+        test_reductions()
         test_determinant()
         test_matrix_inverse()
+        test_lu_solve()
+        test_cholesky()
+        test_qr_lstsq()
+        test_eigen()
+        test_pipeline()
+        test_small_matrices()
+        test_float32()
+        test_save_load()
         test_dot_product()
         test_cross_product()
+        test_sparse()
+        test_numpy_interop()
+        test_copy_on_write()
+        test_batched_ops()
+        test_perf_counters()
+        test_simd_dispatch()
+        test_thread_controls()
+        test_async()
         test_edge_cases()
         
         print("\n" + "="*50)